@@ -1,55 +1,64 @@
 #include <string>
+#include <string_view>
+#include "KMP.hpp"
 #include <vector>
 
 using namespace std;
 
-/* Funcion para crear la tabla de fallos de KMP */
-vector<int> tableKMP(const string& pattern){
+/* Funcion para crear la tabla de fallos de KMP: tablaKMP[i] es el borde mas largo de pattern[0..i]
+(el prefijo mas largo que tambien es sufijo). Ante un fallo se sigue la cadena de bordes en vez de volver
+al inicio, que con patrones periodicos como "AaAAAaa" perderia coincidencias */
+vector<int> tableKMP(string_view pattern){
 	int large = pattern.size();
-	int index = 0;
 	vector<int> tablaKMP(large,0);
-	tablaKMP[0] = -1;
-	for (int i = 1; i < large; ++i){
+	for (int i = 1, index = 0; i < large; ++i){
+		while (index > 0 && pattern[i] != pattern[index]) index = tablaKMP[index - 1];
+		if (pattern[i] == pattern[index]) index++;
 		tablaKMP[i] = index;
-		if(pattern[i] == pattern[index]){
-			index++;
-		}
-		else{
-			index = 0;
-		}
 	}
 	return tablaKMP;
 }
 
-/*KMP Crea una tabla de fallos basandose en cuantas veces se repite el prefijo del patrón dentro de sí,
-de esta forma puede recorrer el texto de forma linear y saltar rapidamente coincidencias que terminaron
-fallando */
-vector<int> KMP(const string& pattern,const string& text){
-	vector<int> f= tableKMP(pattern);
+vector<uint64_t> KMP(string_view pattern, string_view text){
 	//Arreglo para guardar las posiciones donde efectivamente se encuentra el patrón
-	std::vector<int> positionArray;
-	//indexPattern e indexText para recorrer el texto e ir comparandolo con el patrón
-	int m = text.size(), n = pattern.size(), indexPattern =0, indexText = 0;
-	if (m >= n){
-		//Mientras quede texto por analizar
-		while(indexText + indexPattern < m ){
-			//Si hay coincidencia ir moviendo los indices
-			if(pattern[indexPattern] == text[indexPattern+indexText]){
-				indexPattern++;
-			}
-			//Si no, reiniciar indice y saltar posiciones segun la tabla de fallos.
-			else{
-				indexText = indexText + indexPattern - f[indexPattern];
-				if(indexPattern>0 ) indexPattern = f[indexPattern]; 
-			}
-			//Cuando hay coincidencia guardar la posición
-			if(indexPattern == n){
-				positionArray.push_back(indexText);
-				indexPattern = 0;
-				indexText++;
-			}
-		}
-	}
+	std::vector<uint64_t> positionArray;
+	SinkPosiciones sink{&positionArray};
+	KMP(pattern, text, sink);
 	return positionArray;
+}
+
+vector<uint64_t> KMPAutomata(string_view pattern, string_view text){
+	std::vector<uint64_t> positionArray;
+	SinkPosiciones sink{&positionArray};
+	KMPAutomata(pattern, text, sink);
+	return positionArray;
+}
 
-}
\ No newline at end of file
+
+KMPFlujo::KMPFlujo(string_view pattern, bool ignorarMayusculas)
+	: pattern(ignorarMayusculas ? plegar(pattern) : string(pattern)), ignorarMayusculas(ignorarMayusculas),
+	  fallos(tableKMP(this->pattern)) {
+	// Tabla de prefijos completa: en un flujo no se puede retroceder, por lo que
+	// se sigue la cadena de fallos en vez de reiniciar el indice
+}
+
+void KMPFlujo::reiniciar(){
+	estado = 0;
+	procesados = 0;
+}
+
+void KMPFlujo::alimentar(string_view bloque, const function<void(uint64_t)> &reportar){
+	int n = pattern.size();
+	if (n == 0) return;
+	for (size_t i = 0; i < bloque.size(); ++i){
+		char c = ignorarMayusculas ? static_cast<char>(TABLA_PLEGADO[static_cast<unsigned char>(bloque[i])]) : bloque[i];
+		while (estado > 0 && pattern[estado] != c) estado = fallos[estado - 1];
+		if (pattern[estado] == c) estado++;
+		//Cuando hay coincidencia reportar la posición de inicio y seguir por el borde del patrón
+		if (estado == n){
+			reportar(procesados + i + 1 - n);
+			estado = fallos[n - 1];
+		}
+	}
+	procesados += bloque.size();
+}
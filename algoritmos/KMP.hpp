@@ -1,9 +1,163 @@
 #ifndef KMP_HPP
 #define KMP_HPP
 
+#include <array>
+#include <cstdint>
+#include <functional>
 #include <string>
+#include <string_view>
+#include <type_traits>
 #include <vector>
+#include "plegado.hpp"
+#include "resultados.hpp"
 
-std::vector<int> KMP(const std::string &pattern,const std::string &text);
+// Tabla de fallos: el elemento i es el borde mas largo de pattern[0..i]
+std::vector<int> tableKMP(std::string_view pattern);
+
+/*KMP Crea una tabla de fallos basandose en cuantas veces se repite el prefijo del patrón dentro de sí,
+de esta forma puede recorrer el texto de forma linear y saltar rapidamente coincidencias que terminaron
+fallando. Cada coincidencia se entrega al sink (ver resultados.hpp).
+La tabla se calcula una sola vez al construir el objeto y buscar no reserva memoria, así que el mismo
+patrón compilado se reutiliza en todos los archivos o trozos de texto.
+Con SinMayusculas el patrón se pliega al construirlo y el texto se pliega al compararlo (ver plegado.hpp) */
+template <class Plegar = Exacto>
+class KMPCompilado {
+public:
+	explicit KMPCompilado(std::string_view patron)
+		: pattern(Plegar::activo ? plegar(patron) : std::string(patron)) {
+		if (!pattern.empty()) f = tableKMP(pattern);
+	}
+
+	template <class Sink>
+	void buscar(std::string_view text, Sink &sink) const;
+
+	size_t largo() const { return pattern.size(); }
+
+private:
+	std::string pattern;
+	std::vector<int> f; // Tabla de fallos (ver tableKMP)
+};
+
+template <class Plegar>
+template <class Sink>
+void KMPCompilado<Plegar>::buscar(std::string_view text, Sink &sink) const {
+	if (pattern.empty()) return;
+	Plegar plegar;
+	//indexPattern son los caracteres del patrón que coinciden con el texto que termina en indexText
+	int64_t m = text.size(), n = pattern.size(), indexPattern = 0;
+	for (int64_t indexText = 0; indexText < m; ++indexText){
+		unsigned char c = plegar(text[indexText]);
+		//Si no hay coincidencia seguir la cadena de fallos hasta un borde que pueda continuar con c
+		anotar(sink, &Estadisticas::comparaciones);
+		while (indexPattern > 0 && static_cast<unsigned char>(pattern[indexPattern]) != c){
+			indexPattern = f[indexPattern - 1];
+			anotar(sink, &Estadisticas::transiciones_fallo);
+			anotar(sink, &Estadisticas::comparaciones);
+		}
+		if (static_cast<unsigned char>(pattern[indexPattern]) == c) indexPattern++;
+		//Cuando hay coincidencia entregar la posición y seguir por el borde del patrón (para las que se solapan)
+		if (indexPattern == n){
+			if (!sink.reportar(indexText + 1 - n)) return;
+			indexPattern = f[n - 1];
+		}
+	}
+}
+
+// Compila el patrón y lo busca una vez (para buscar el mismo patrón varias veces usar KMPCompilado)
+template <class Sink>
+void KMP(std::string_view pattern, std::string_view text, Sink &sink){
+	KMPCompilado<>(pattern).buscar(text, sink);
+}
+
+std::vector<uint64_t> KMP(std::string_view pattern, std::string_view text);
+
+/* KMP como automata determinista: el patron se compila en una tabla completa de (m + 1) x 256 transiciones,
+donde tabla[estado * 256 + byte] es el siguiente estado (caracteres del patron que coinciden). El ciclo de
+busqueda hace una sola lectura de la tabla por byte, sin seguir la cadena de fallos, por lo que el costo por
+byte es el mismo en textos adversos como "aaaa...ab". Los estados se guardan ya multiplicados por 256 para que
+el paso sea solo una suma y una lectura.
+Max es el largo maximo del patron conocido al compilar: con Max > 0 la tabla vive dentro del objeto y los
+estados son de 16 bits (Max = 8 ocupa 4,5 KB y Max = 16, 8,5 KB, dentro de la cache L1); con Max = 0 la tabla
+se reserva en el heap con estados de 32 bits.
+Con ignorarMayusculas el automata se arma con el patron plegado y la columna de cada mayuscula se copia de
+la de su minuscula, asi el ciclo de busqueda no cambia. */
+template <size_t Max>
+class AutomataKMP {
+public:
+	using Estado = std::conditional_t<(Max > 0 && Max < 256), uint16_t, uint32_t>;
+
+	explicit AutomataKMP(std::string_view patron, bool ignorarMayusculas = false) : largo(patron.size()) {
+		if constexpr (Max == 0) tabla.assign((largo + 1) * 256, 0);
+		else tabla.fill(0);
+		if (largo == 0) return;
+		std::string plegado = ignorarMayusculas ? plegar(patron) : std::string();
+		std::string_view pattern = ignorarMayusculas ? std::string_view(plegado) : patron;
+
+		// x es el estado al que se llega con el patron sin su primer caracter (el borde del prefijo actual)
+		tabla[(unsigned char)pattern[0]] = 1 * 256;
+		size_t x = 0;
+		for (size_t j = 1; j <= largo; ++j){
+			for (size_t c = 0; c < 256; ++c) tabla[j * 256 + c] = tabla[x * 256 + c];
+			if (j == largo) break;
+			unsigned char siguiente = pattern[j];
+			tabla[j * 256 + siguiente] = (j + 1) * 256;
+			x = tabla[x * 256 + siguiente] / 256;
+		}
+		if (ignorarMayusculas) {
+			for (size_t j = 0; j <= largo; ++j) extenderPlegado(tabla, 1, j * 256);
+		}
+	}
+
+	template <class Sink>
+	void buscar(std::string_view text, Sink &sink) const {
+		if (largo == 0) return;
+		const Estado *t = tabla.data();
+		const Estado aceptacion = largo * 256;
+		Estado estado = 0;
+		for (size_t i = 0; i < text.size(); ++i){
+			estado = t[estado + (unsigned char)text[i]];
+			//Al llegar al ultimo estado hay coincidencia; la fila de ese estado ya continua por el borde del patron
+			if (estado == aceptacion && !sink.reportar(i + 1 - largo)) return;
+		}
+	}
+
+private:
+	size_t largo;
+	std::conditional_t<Max == 0, std::vector<Estado>, std::array<Estado, (Max + 1) * 256>> tabla;
+};
+
+// Largo maximo del patron para el automata en el heap (tabla de 1 MB con estados de 32 bits)
+constexpr size_t LARGO_MAXIMO_AUTOMATA = 1024;
+
+/* Elige el automata segun el largo del patron: tablas dentro del objeto para patrones de hasta 8 y 16 bytes,
+tabla en el heap hasta LARGO_MAXIMO_AUTOMATA y KMP con tabla de fallos para patrones mas largos. */
+template <class Sink>
+void KMPAutomata(std::string_view pattern, std::string_view text, Sink &sink){
+	size_t m = pattern.size();
+	if (m == 0) return;
+	if (m <= 8) AutomataKMP<8>(pattern).buscar(text, sink);
+	else if (m <= 16) AutomataKMP<16>(pattern).buscar(text, sink);
+	else if (m <= LARGO_MAXIMO_AUTOMATA) AutomataKMP<0>(pattern).buscar(text, sink);
+	else KMP(pattern, text, sink);
+}
+
+std::vector<uint64_t> KMPAutomata(std::string_view pattern, std::string_view text);
+
+/* KMP para flujos: recibe el texto en bloques y conserva entre bloques el estado del automata
+(cuantos caracteres del patron estan coincidiendo), por lo que usa memoria O(m) sin importar el
+largo del flujo. Las posiciones reportadas son absolutas dentro del flujo (64 bits). */
+class KMPFlujo {
+public:
+	explicit KMPFlujo(std::string_view pattern, bool ignorarMayusculas = false);
+	void alimentar(std::string_view bloque, const std::function<void(uint64_t)> &reportar);
+	void reiniciar(); // Volver al inicio de un flujo nuevo, conservando la tabla del patron
+
+private:
+	std::string pattern;		// Patron (plegado si ignorarMayusculas)
+	bool ignorarMayusculas;
+	std::vector<int> fallos;	// fallos[i] = borde mas largo de pattern[0..i]
+	int estado = 0;				// Caracteres del patron que coinciden hasta ahora
+	uint64_t procesados = 0;	// Bytes del flujo ya procesados
+};
 
 #endif // KMP_HPP
\ No newline at end of file
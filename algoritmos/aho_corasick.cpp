@@ -0,0 +1,126 @@
+/* Implementacion del algoritmo Aho-Corasick para buscar varios patrones a la vez.
+   Se construye un trie con todos los patrones y se agregan enlaces de fallo (el sufijo propio
+   mas largo que tambien es prefijo de algun patron), de forma que el texto se recorre una sola vez
+   sin retroceder. La complejidad es O(n + largo total de los patrones + cantidad de coincidencias).
+*/
+
+#include <array>
+#include <queue>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <algorithm>
+#include "aho_corasick.hpp"
+#include "plegado.hpp"
+
+using namespace std;
+
+namespace aho_corasick {
+
+    // Nodo del trie. Los hijos se guardan ordenados por byte para no reservar 256 entradas por nodo,
+    // ya que los patrones de generar_patrones pueden ser muy largos.
+    struct Nodo {
+        vector<pair<unsigned char, int>> hijos;
+        int fallo = 0;      // Enlace de fallo
+        int salida = -1;    // Nodo terminal mas cercano siguiendo los enlaces de fallo
+        int patron = -1;    // Patron que termina en este nodo (-1 si ninguno)
+        int profundidad = 0;
+    };
+
+    int hijo(const Nodo &nodo, unsigned char c) {
+        auto it = lower_bound(nodo.hijos.begin(), nodo.hijos.end(), make_pair(c, 0));
+        if (it != nodo.hijos.end() && it->first == c) return it->second;
+        return -1;
+    }
+
+    class Automata {
+    public:
+        explicit Automata(const vector<string> &patrones) : duplicado(patrones.size(), -1) {
+            nodos.emplace_back(); // Raiz
+
+            // Insertar cada patron en el trie
+            for (size_t p = 0; p < patrones.size(); p++) {
+                if (patrones[p].empty()) continue; // Un patron vacio no tiene coincidencias
+                int actual = 0;
+                for (unsigned char c : patrones[p]) {
+                    int siguiente = hijo(nodos[actual], c);
+                    if (siguiente < 0) {
+                        siguiente = nodos.size();
+                        nodos.emplace_back();
+                        nodos[siguiente].profundidad = nodos[actual].profundidad + 1;
+                        auto &hijos = nodos[actual].hijos;
+                        hijos.insert(lower_bound(hijos.begin(), hijos.end(), make_pair(c, 0)), {c, siguiente});
+                    }
+                    actual = siguiente;
+                }
+                // Los patrones repetidos comparten nodo, se recuerda a cual corresponden
+                if (nodos[actual].patron < 0) nodos[actual].patron = p;
+                else duplicado[p] = nodos[actual].patron;
+            }
+
+            // La raiz usa una tabla completa para no buscar en sus hijos en cada fallo
+            raiz.fill(0);
+            for (auto [c, h] : nodos[0].hijos) raiz[c] = h;
+
+            // Calcular enlaces de fallo recorriendo el trie por niveles (BFS).
+            // Los hijos de la raiz fallan a la raiz, que ya es el valor inicial.
+            queue<int> cola;
+            for (auto [c, h] : nodos[0].hijos) cola.push(h);
+            while (!cola.empty()) {
+                int u = cola.front();
+                cola.pop();
+                for (auto [c, v] : nodos[u].hijos) {
+                    nodos[v].fallo = transicion(nodos[u].fallo, c);
+                    int f = nodos[v].fallo;
+                    nodos[v].salida = nodos[f].patron >= 0 ? f : nodos[f].salida;
+                    cola.push(v);
+                }
+            }
+        }
+
+        // Siguiente estado desde 'estado' leyendo el byte c
+        int transicion(int estado, unsigned char c) const {
+            while (estado != 0) {
+                int h = hijo(nodos[estado], c);
+                if (h >= 0) return h;
+                estado = nodos[estado].fallo;
+            }
+            return raiz[c];
+        }
+
+        template <class Plegar>
+        vector<vector<uint64_t>> buscar(string_view texto, size_t cant_patrones, Plegar plegar) const {
+            vector<vector<uint64_t>> posiciones(cant_patrones);
+            int estado = 0;
+            for (size_t i = 0; i < texto.size(); i++) {
+                estado = transicion(estado, plegar(texto[i]));
+
+                // Reportar todos los patrones que terminan en la posicion i
+                int t = nodos[estado].patron >= 0 ? estado : nodos[estado].salida;
+                while (t >= 0) {
+                    posiciones[nodos[t].patron].push_back(i + 1 - nodos[t].profundidad);
+                    t = nodos[t].salida;
+                }
+            }
+
+            // Copiar los resultados a los patrones repetidos
+            for (size_t p = 0; p < cant_patrones; p++) {
+                if (duplicado[p] >= 0) posiciones[p] = posiciones[duplicado[p]];
+            }
+            return posiciones;
+        }
+
+    private:
+        vector<Nodo> nodos;
+        array<int, 256> raiz;
+        vector<int> duplicado; // Para cada patron repetido, el indice de su primera aparicion
+    };
+}
+
+vector<vector<uint64_t>> ahoCorasick(string_view text, const vector<string> &patterns, bool ignorarMayusculas) {
+    if (!ignorarMayusculas) return aho_corasick::Automata(patterns).buscar(text, patterns.size(), Exacto());
+
+    vector<string> plegados;
+    for (const string &patron : patterns) plegados.push_back(plegar(patron));
+    return aho_corasick::Automata(plegados).buscar(text, plegados.size(), SinMayusculas());
+}
@@ -0,0 +1,15 @@
+#ifndef AHO_CORASICK_HPP
+#define AHO_CORASICK_HPP
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Busca todos los patrones en una sola pasada sobre el texto.
+// Devuelve, para cada patrón (en el mismo orden de entrada), las posiciones donde aparece.
+// Con ignorarMayusculas el trie se arma con los patrones plegados y el texto se pliega al recorrerlo.
+std::vector<std::vector<uint64_t>> ahoCorasick(std::string_view text, const std::vector<std::string> &patterns,
+                                               bool ignorarMayusculas = false);
+
+#endif // AHO_CORASICK_HPP
@@ -0,0 +1,48 @@
+/* Algoritmos de paralelismo de bits: Shift-Or y BNDM.
+   Ambos representan el estado de un autómata no determinista del patrón con un bit por byte del patrón,
+   así que avanzar todos los estados a la vez cuesta unas pocas operaciones sobre un registro de 64 bits.
+   Referencia: G. Navarro y M. Raffinot, "Flexible Pattern Matching in Strings", capítulo 2.
+*/
+
+#include "bit_paralelo.hpp"
+
+using namespace std;
+
+ShiftOr::ShiftOr(string_view pat, bool ignorarMayusculas)
+    : m(pat.size()), palabras(max<size_t>(1, (pat.size() + BITS_REGISTRO - 1) / BITS_REGISTRO)) {
+    mascaras.assign(256 * palabras, ~uint64_t(0));
+    for (size_t i = 0; i < m; ++i) {
+        unsigned char c = ignorarMayusculas ? TABLA_PLEGADO[(unsigned char)pat[i]] : pat[i];
+        mascaras[c * palabras + i / BITS_REGISTRO] &= ~(uint64_t(1) << (i % BITS_REGISTRO));
+    }
+    if (ignorarMayusculas) extenderPlegado(mascaras, palabras);
+}
+
+uint64_t *estadoShiftOr(size_t palabras) {
+    static thread_local vector<uint64_t> estado;
+    if (estado.size() < palabras) estado.resize(palabras);
+    return estado.data();
+}
+
+BNDM::BNDM(string_view patron, bool ignorarMayusculas)
+    : pat(ignorarMayusculas ? plegar(patron) : string(patron)), ignorarMayusculas(ignorarMayusculas),
+      ventana(min(patron.size(), BITS_REGISTRO)) {
+    for (size_t i = 0; i < ventana; ++i) {
+        mascaras[(unsigned char)pat[i]] |= uint64_t(1) << (ventana - 1 - i);
+    }
+    if (ignorarMayusculas) extenderPlegado(mascaras);
+}
+
+vector<uint64_t> shiftOr(string_view text, string_view pattern) {
+    vector<uint64_t> posiciones;
+    SinkPosiciones sink{&posiciones};
+    ShiftOr(pattern).buscar(text, sink);
+    return posiciones;
+}
+
+vector<uint64_t> bndm(string_view text, string_view pattern) {
+    vector<uint64_t> posiciones;
+    SinkPosiciones sink{&posiciones};
+    BNDM(pattern).buscar(text, sink);
+    return posiciones;
+}
@@ -0,0 +1,149 @@
+#ifndef BIT_PARALELO_HPP
+#define BIT_PARALELO_HPP
+
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "plegado.hpp"
+#include "resultados.hpp"
+
+// Bits de un registro: hasta este largo el estado del patrón cabe en un solo uint64_t
+constexpr size_t BITS_REGISTRO = 64;
+
+// Palabras del estado de Shift-Or que se guardan en la pila durante la búsqueda (patrones de hasta 1024 bytes).
+// Con más palabras el estado va en un buffer por hilo que se reutiliza entre búsquedas (ver estadoShiftOr).
+constexpr size_t PALABRAS_EN_PILA = 16;
+
+// Buffer por hilo para el estado de Shift-Or con patrones de más de PALABRAS_EN_PILA palabras. Solo crece
+// la primera vez que el hilo busca un patrón de ese largo, así buscar no reserva memoria en cada llamada.
+uint64_t *estadoShiftOr(size_t palabras);
+
+/* Shift-Or: simula el autómata no determinista del patrón con un bit por estado.
+   El bit i del estado vale 0 si los últimos i + 1 bytes leídos coinciden con el prefijo de largo i + 1.
+   Por cada byte del texto: estado = (estado << 1) | mascara[byte], sin ramas que dependan de los datos.
+   Con patrones de más de 64 bytes el estado ocupa varias palabras y el bit que sale de una entra a la siguiente.
+   Sin distinguir mayúsculas, la máscara de cada mayúscula es la de su minúscula (ver plegado.hpp). */
+class ShiftOr {
+public:
+    explicit ShiftOr(std::string_view pat, bool ignorarMayusculas = false);
+
+    template <class Sink>
+    void buscar(std::string_view txt, Sink &sink) const;
+
+    size_t largo() const { return m; }
+
+private:
+    template <class Sink>
+    void buscarVariasPalabras(std::string_view txt, Sink &sink) const;
+
+    size_t m;
+    size_t palabras;                 // Palabras de 64 bits del estado
+    std::vector<uint64_t> mascaras;  // mascaras[byte * palabras + w]: bit i en 0 si pat[64 * w + i] == byte
+};
+
+/* BNDM (Backward Nondeterministic DAWG Matching): lee la ventana de derecha a izquierda simulando con bits
+   el autómata de sufijos del patrón invertido. Cuando ningún factor del patrón termina en el byte leído se
+   salta la ventana, desplazándola hasta el último prefijo del patrón reconocido, por lo que en promedio
+   lee menos de un byte del texto por posición (sublineal).
+   Con patrones de más de 64 bytes el autómata se arma con los primeros 64 bytes y cada coincidencia de ese
+   prefijo se verifica con el resto del patrón. */
+class BNDM {
+public:
+    explicit BNDM(std::string_view pat, bool ignorarMayusculas = false);
+
+    template <class Sink>
+    void buscar(std::string_view txt, Sink &sink) const;
+
+    size_t largo() const { return pat.size(); }
+
+private:
+    std::string pat;                         // Patrón (plegado si ignorarMayusculas)
+    bool ignorarMayusculas;
+    size_t ventana;                          // Bytes del patrón simulados con bits (a lo más 64)
+    std::array<uint64_t, 256> mascaras{};    // Bit ventana - 1 - i en 1 si pat[i] == byte
+};
+
+template <class Sink>
+void ShiftOr::buscar(std::string_view txt, Sink &sink) const {
+
+    if (m == 0 || txt.size() < m) return;
+    if (palabras > 1) {
+        buscarVariasPalabras(txt, sink);
+        return;
+    }
+
+    const uint64_t *b = mascaras.data();
+    const uint64_t final_patron = uint64_t(1) << (m - 1);
+    uint64_t estado = ~uint64_t(0);
+    for (size_t i = 0; i < txt.size(); ++i) {
+        estado = (estado << 1) | b[(unsigned char)txt[i]];
+        if (!(estado & final_patron) && !sink.reportar(i + 1 - m)) return;
+    }
+}
+
+template <class Sink>
+void ShiftOr::buscarVariasPalabras(std::string_view txt, Sink &sink) const {
+
+    uint64_t en_pila[PALABRAS_EN_PILA];
+    uint64_t *estado = palabras <= PALABRAS_EN_PILA ? en_pila : estadoShiftOr(palabras);
+    std::fill(estado, estado + palabras, ~uint64_t(0));
+    const size_t ultima = palabras - 1;
+    const uint64_t final_patron = uint64_t(1) << ((m - 1) % BITS_REGISTRO);
+    for (size_t i = 0; i < txt.size(); ++i) {
+        const uint64_t *b = &mascaras[(unsigned char)txt[i] * palabras];
+        // De la palabra más alta a la más baja, para usar el bit alto de la palabra anterior antes de desplazarla
+        for (size_t w = ultima; w > 0; --w) estado[w] = (estado[w] << 1) | (estado[w - 1] >> 63) | b[w];
+        estado[0] = (estado[0] << 1) | b[0];
+        if (!(estado[ultima] & final_patron) && !sink.reportar(i + 1 - m)) return;
+    }
+}
+
+template <class Sink>
+void BNDM::buscar(std::string_view txt, Sink &sink) const {
+
+    size_t m = pat.size();
+    size_t n = txt.size();
+    if (m == 0 || n < m) return;
+
+    const uint64_t inicio_ventana = uint64_t(1) << (ventana - 1);
+    const uint64_t todos = ventana == BITS_REGISTRO ? ~uint64_t(0) : (uint64_t(1) << ventana) - 1;
+
+    size_t pos = 0;
+    while (pos <= n - m) {
+        size_t j = ventana;
+        size_t ultimo = ventana;  // Desplazamiento: ventana menos el prefijo más largo visto
+        uint64_t estado = todos;
+        while (estado != 0) {
+            estado &= mascaras[(unsigned char)txt[pos + j - 1]];
+            --j;
+            anotar(sink, &Estadisticas::comparaciones);
+            if (estado & inicio_ventana) {
+                if (j > 0) {
+                    ultimo = j; // Lo leído hasta ahora es un prefijo del patrón
+                } else {
+                    // La ventana completa coincide; el resto del patrón (más de 64 bytes) se compara directo
+                    const char *resto = txt.data() + pos + ventana;
+                    bool coincide = m == ventana ||
+                                    (ignorarMayusculas ? iguales(resto, pat.data() + ventana, m - ventana, SinMayusculas())
+                                                       : std::memcmp(resto, pat.data() + ventana, m - ventana) == 0);
+                    anotar(sink, &Estadisticas::comparaciones, m - ventana);
+                    if (coincide && !sink.reportar(pos)) return;
+                    break;
+                }
+            }
+            estado = (estado << 1) & todos;
+        }
+        pos += ultimo;
+        anotar(sink, &Estadisticas::desplazamientos);
+        anotar(sink, &Estadisticas::total_desplazado, ultimo);
+    }
+}
+
+std::vector<uint64_t> shiftOr(std::string_view text, std::string_view pattern);
+std::vector<uint64_t> bndm(std::string_view text, std::string_view pattern);
+
+#endif // BIT_PARALELO_HPP
@@ -2,6 +2,8 @@
    El algoritmo se basa en dos heurísticas: Bad Character y Good Suffix.
    El algoritmo tiene una complejidad temporal promedio de O(n/m) y una complejidad espacial de O(m), donde n es el tamaño del texto y m es el tamaño del patrón.
    El algoritmo es eficiente para buscar patrones en textos grandes y es ampliamente utilizado en aplicaciones de procesamiento de texto.
+   Con la regla de Galil, despues de una coincidencia solo se comparan los bytes nuevos de la ventana,
+   por lo que el peor caso (patrones periodicos como "aaaa" sobre "aaaa...") es O(n) en vez de O(n*m).
 
    Implementacion obtenida de: https://www.tutorialspoint.com/data_structures_algorithms/boyer_moore_algorithm.htm
 */
@@ -12,7 +14,7 @@
 using namespace std;
 
 // Funcion para calcular el desplazamiento completo del patrón
-void computeFullShift(int shiftArr[], int longSuffArr[], string patrn) {
+static void computeFullShift(vector<int> &shiftArr, vector<int> &longSuffArr, string_view patrn) {
 
     
     int n = patrn.size(); 
@@ -38,14 +40,14 @@ void computeFullShift(int shiftArr[], int longSuffArr[], string patrn) {
 }
 
 // Funcion para computar Good Suffix 
-void computeGoodSuffix(int shiftArr[], int longSuffArr[], string patrn) {
+static void computeGoodSuffix(vector<int> &shiftArr, const vector<int> &longSuffArr, string_view patrn) {
     
     int n = patrn.size();  // Largo del patrón
     int j;
     j = longSuffArr[0];
     
     // Recorrer el patrón
-    for(int i = 0; i<n; i++) {
+    for(int i = 0; i<=n; i++) {
         // setting shift to long suffix value 
         if(shiftArr[i] == 0) {
             shiftArr[i] = j; 
@@ -57,56 +59,89 @@ void computeGoodSuffix(int shiftArr[], int longSuffArr[], string patrn) {
     }
 }
 
-// Funcion para buscar el patrón en la cadena original y almacenar las posiciones en un vector
-void searchPattern(string orgnStr, string patrn, vector<int> *position_array) {
-    
-    int patLen = patrn.size();          // Largo del patron
-    int strLen = orgnStr.size();        // Largo de la cadena original
-    int longerSuffArray[patLen + 1];    // Array para almacenar los sufijos largos
-    int shiftArr[patLen + 1];           // Array para almacenar los desplazamientos
-
-    // Inicializando los elementos del array de desplazamientos a 0
-    for(int i = 0; i <= patLen; i++) {
-        shiftArr[i] = 0;
+BoyerMoore::BoyerMoore(string_view patron, bool ignorarMayusculas)
+    : pat(ignorarMayusculas ? plegar(patron) : string(patron)), ignorarMayusculas(ignorarMayusculas),
+      shiftArr(patron.size() + 1, 0) {
+
+    int patLen = pat.size();
+
+    // Bad Character: última aparición de cada byte en el patrón
+    ultimaOcurrencia.fill(-1);
+    for (int i = 0; i < patLen; i++) {
+        ultimaOcurrencia[static_cast<unsigned char>(pat[i])] = i;
+    }
+
+    // Horspool: distancia desde la última aparición de cada byte (sin contar el último) hasta el final
+    saltoHorspool.fill(max(patLen, 1));
+    for (int i = 0; i + 1 < patLen; i++) {
+        saltoHorspool[static_cast<unsigned char>(pat[i])] = patLen - 1 - i;
+    }
+
+    // Sin distinguir mayúsculas, cada mayúscula del texto salta lo mismo que su minúscula
+    if (ignorarMayusculas) {
+        extenderPlegado(ultimaOcurrencia);
+        extenderPlegado(saltoHorspool);
     }
 
+    if (patLen == 0) return;
+
     /* Llamando a la función computeFullShift y computeGoodSuffix para calcular los desplazamientos
     * La primera calcula los desplazamientos completos para el patrón y la segunda calcula los  
     * desplazamientos de Good Suffix.
     * Estas funciones son parte de la heurística del algoritmo Boyer-Moore.
     */
-    computeFullShift(shiftArr, longerSuffArray, patrn); 
-    computeGoodSuffix(shiftArr, longerSuffArray, patrn); 
-    
-    int shift = 0;
-    while(shift <= (strLen - patLen)) {
-        int j = patLen - 1;
-        // disminuir j cuando el patron y el caracter de la cadena principal coinciden
-        while(j >= 0 && patrn[j] == orgnStr[shift+j]) {
-            j--; 
-        }
+    vector<int> longerSuffArray(patLen + 1); // Array para almacenar los sufijos largos
+    computeFullShift(shiftArr, longerSuffArray, pat); 
+    computeGoodSuffix(shiftArr, longerSuffArray, pat); 
 
-        // Si j es menor que 0, significa que se encontró el patrón
-        if(j < 0) {
-            // almacenar la posición donde se encuentra el patrón
-            // cout << shift << endl; // Imprimir la posición donde se encontró el patrón
-            position_array->push_back(shift); 
-            shift += max(shiftArr[0], 1);   // Desplazar el patrón 
-        } else {
-            // Si j es mayor o igual a 0, significa que no se encontró el patrón
-            shift += max(shiftArr[j+1], 1); // Desplazar el patrón
-        }
-    }
+    // shiftArr[0] es el periodo del patrón: el menor desplazamiento que lo hace coincidir consigo mismo
+    periodo = max(shiftArr[0], 1);
 }
 
-vector<int> boyer_moore(const std::string &txt, const std::string &pat) {
+vector<uint64_t> boyer_moore(std::string_view txt, std::string_view pat) {
 
     // Vector para guardar las posiciones donde se encuentra el patrón
-    vector<int> locArray;
+    vector<uint64_t> locArray;
+    SinkPosiciones sink{&locArray};
 
     // Llamar a la función de búsqueda del patrón
-    searchPattern(txt, pat, &locArray); 
+    BoyerMoore(pat).buscar(txt, sink); 
 
-    // Imprimir las posiciones donde se encuentra el patrón
     return locArray;
 }
+
+vector<uint64_t> horspool(std::string_view txt, std::string_view pat) {
+    vector<uint64_t> locArray;
+    SinkPosiciones sink{&locArray};
+    BoyerMoore(pat).buscarHorspool(txt, sink);
+    return locArray;
+}
+
+BoyerMooreFlujo::BoyerMooreFlujo(std::string_view pat, bool ignorarMayusculas) : bm(pat, ignorarMayusculas) {}
+
+void BoyerMooreFlujo::reiniciar() {
+    ventana.clear();
+    procesados = 0;
+}
+
+void BoyerMooreFlujo::alimentar(std::string_view bloque, const std::function<void(uint64_t)> &reportar) {
+
+    size_t m = bm.largo();
+    if (m == 0) return;
+
+    // Posición absoluta del primer byte de la ventana (la cola tiene a lo más m-1 bytes)
+    uint64_t inicio_ventana = procesados - ventana.size();
+    ventana.append(bloque.data(), bloque.size());
+    procesados += bloque.size();
+
+    // Una coincidencia mide m bytes, así que nunca cabe completa en la cola:
+    // cada coincidencia se reporta una sola vez
+    auto sink = sinkFuncion([&](uint64_t pos) {
+        reportar(inicio_ventana + pos);
+        return true;
+    });
+    bm.buscar(ventana, sink);
+
+    // Conservar solo los últimos m-1 bytes para el siguiente bloque
+    if (ventana.size() > m - 1) ventana.erase(0, ventana.size() - (m - 1));
+}
@@ -1,10 +1,139 @@
 #ifndef BOYER_MOORE_HPP
 #define BOYER_MOORE_HPP
 
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <cstdint>
+#include <functional>
 #include <string>
+#include <string_view>
 #include <vector>
+#include "plegado.hpp"
+#include "resultados.hpp"
 
+// Tablas de Boyer-Moore de un patrón. Se calculan una sola vez y se reutilizan para buscar
+// en todos los archivos o trozos de texto, sin volver a preprocesar el patrón.
+// Las búsquedas son plantillas sobre el sink de resultados (ver resultados.hpp).
+// Con ignorarMayusculas las tablas se arman con el patrón plegado (ver plegado.hpp).
+class BoyerMoore {
+public:
+    explicit BoyerMoore(std::string_view pat, bool ignorarMayusculas = false);
 
-std::vector<int> boyer_moore(const std::string &txt, const std::string &pat);
+    // Boyer-Moore completo: Bad Character + Good Suffix, con la regla de Galil para patrones periódicos
+    template <class Sink>
+    void buscar(std::string_view txt, Sink &sink) const;
 
-#endif // BOYER_MOORE_HPP
\ No newline at end of file
+    // Variante de Horspool: solo usa el Bad Character del último byte de la ventana
+    template <class Sink>
+    void buscarHorspool(std::string_view txt, Sink &sink) const;
+
+    size_t largo() const { return pat.size(); }
+
+private:
+    template <class Plegar, class Sink>
+    void buscarCon(std::string_view txt, Sink &sink, Plegar plegar) const;
+
+    template <class Plegar, class Sink>
+    void buscarHorspoolCon(std::string_view txt, Sink &sink, Plegar plegar) const;
+
+    std::string pat;                       // Patrón (plegado si ignorarMayusculas)
+    bool ignorarMayusculas;
+    std::array<int, 256> ultimaOcurrencia; // Última posición de cada byte en el patrón (-1 si no aparece)
+    std::array<size_t, 256> saltoHorspool; // Desplazamiento de Horspool según el último byte de la ventana
+    std::vector<int> shiftArr;             // Desplazamientos de Good Suffix (m + 1 entradas)
+    size_t periodo = 0;                    // Periodo del patrón (desplazamiento tras una coincidencia)
+};
+
+template <class Sink>
+void BoyerMoore::buscar(std::string_view txt, Sink &sink) const {
+    if (ignorarMayusculas) buscarCon(txt, sink, SinMayusculas());
+    else buscarCon(txt, sink, Exacto());
+}
+
+template <class Sink>
+void BoyerMoore::buscarHorspool(std::string_view txt, Sink &sink) const {
+    if (ignorarMayusculas) buscarHorspoolCon(txt, sink, SinMayusculas());
+    else buscarHorspoolCon(txt, sink, Exacto());
+}
+
+// Funcion para buscar el patrón en la cadena original y entregar las posiciones al sink
+template <class Plegar, class Sink>
+void BoyerMoore::buscarCon(std::string_view orgnStr, Sink &sink, Plegar plegar) const {
+
+    size_t patLen = pat.size();         // Largo del patron
+    size_t strLen = orgnStr.size();     // Largo de la cadena original
+    if (patLen == 0 || strLen < patLen) return;
+
+    size_t shift = 0;
+    long limite = 0; // Regla de Galil: los bytes antes de 'limite' ya se sabe que coinciden
+    while(shift <= strLen - patLen) {
+        long j = patLen - 1;
+        // disminuir j cuando el patron y el caracter de la cadena principal coinciden
+        while(j >= limite && static_cast<unsigned char>(pat[j]) == plegar(orgnStr[shift+j])) {
+            j--; 
+        }
+        anotar(sink, &Estadisticas::comparaciones, patLen - j - (j < limite ? 1 : 0));
+
+        // Si j es menor que el límite, significa que se encontró el patrón
+        if(j < limite) {
+            // entregar la posición donde se encuentra el patrón
+            if (!sink.reportar(shift)) return;
+            shift += periodo;   // Desplazar el patrón según su periodo
+            anotar(sink, &Estadisticas::desplazamientos);
+            anotar(sink, &Estadisticas::total_desplazado, periodo);
+            // Tras desplazar por el periodo, los primeros m - periodo bytes de la ventana ya coinciden
+            limite = patLen - periodo;
+        } else {
+            // Si j es mayor o igual al límite, significa que no se encontró el patrón.
+            // Se usa el mayor desplazamiento entre Good Suffix y Bad Character
+            long malo = j - ultimaOcurrencia[static_cast<unsigned char>(orgnStr[shift+j])];
+            long salto = std::max<long>(shiftArr[j+1], malo);
+            shift += salto; // Desplazar el patrón
+            limite = 0;
+            anotar(sink, &Estadisticas::desplazamientos);
+            anotar(sink, &Estadisticas::total_desplazado, salto);
+        }
+    }
+}
+
+template <class Plegar, class Sink>
+void BoyerMoore::buscarHorspoolCon(std::string_view orgnStr, Sink &sink, Plegar plegar) const {
+
+    size_t patLen = pat.size();
+    size_t strLen = orgnStr.size();
+    if (patLen == 0 || strLen < patLen) return;
+
+    unsigned char ultimo = pat[patLen - 1];
+    for (size_t shift = 0; shift <= strLen - patLen; ) {
+        unsigned char c = orgnStr[shift + patLen - 1];
+        // Comparar primero el último byte y luego el resto de la ventana
+        anotar(sink, &Estadisticas::comparaciones, plegar(c) == ultimo ? patLen : 1);
+        if (plegar(c) == ultimo && iguales(orgnStr.data() + shift, pat.data(), patLen - 1, plegar)) {
+            if (!sink.reportar(shift)) return;
+        }
+        shift += saltoHorspool[c];
+        anotar(sink, &Estadisticas::desplazamientos);
+        anotar(sink, &Estadisticas::total_desplazado, saltoHorspool[c]);
+    }
+}
+
+std::vector<uint64_t> boyer_moore(std::string_view txt, std::string_view pat);
+std::vector<uint64_t> horspool(std::string_view txt, std::string_view pat);
+
+// Boyer-Moore para flujos: antes de cada bloque se antepone la cola de m-1 bytes del bloque anterior,
+// asi se encuentran las coincidencias que cruzan el borde sin guardar todo el texto.
+// Las posiciones reportadas son absolutas dentro del flujo (64 bits).
+class BoyerMooreFlujo {
+public:
+    explicit BoyerMooreFlujo(std::string_view pat, bool ignorarMayusculas = false);
+    void alimentar(std::string_view bloque, const std::function<void(uint64_t)> &reportar);
+    void reiniciar(); // Volver al inicio de un flujo nuevo, conservando las tablas del patrón
+
+private:
+    BoyerMoore bm;
+    std::string ventana;     // Cola del bloque anterior seguida del bloque actual (se reutiliza)
+    uint64_t procesados = 0; // Bytes del flujo ya procesados
+};
+
+#endif // BOYER_MOORE_HPP
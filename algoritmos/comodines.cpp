@@ -0,0 +1,132 @@
+/* Patrones con comodines: lectura de la sintaxis y elección del factor literal que se usa como prefiltro.
+   La búsqueda está en comodines.hpp (plantilla sobre el sink).
+*/
+
+#include "comodines.hpp"
+#include "plegado.hpp"
+
+using namespace std;
+
+// Sin distinguir mayúsculas, la clase acepta ambos casos de cada letra que ya tiene
+static void plegarClase(bitset<256> &clase) {
+    for (unsigned b = 0; b < 256; ++b) {
+        if (clase[b]) clase.set(TABLA_PLEGADO[b]);
+    }
+    for (unsigned b = 0; b < 256; ++b) {
+        if (clase[TABLA_PLEGADO[b]]) clase.set(b);
+    }
+}
+
+PatronComodin::PatronComodin(string_view patron, const string &algoritmo, bool ignorarMayusculas) {
+
+    // Cada elemento del patrón es una clase de bytes; 'literales' guarda el byte de los elementos literales
+    // (-1 para ?, [...]) para elegir después el factor
+    vector<vector<int>> literales(1);
+    segmentos.assign(1, Segmento());
+
+    Clase cualquiera;
+    cualquiera.set();
+    cualquiera.reset('\n');
+
+    for (size_t i = 0; i < patron.size(); ++i) {
+        char c = patron[i];
+        if (c == '*') {
+            // Un '*' seguido de otro, o al comienzo, no agrega un segmento nuevo
+            if (!segmentos.back().empty()) {
+                segmentos.emplace_back();
+                literales.emplace_back();
+            }
+            continue;
+        }
+
+        Clase clase;
+        int literal = -1;
+        if (c == '?') {
+            clase = cualquiera;
+        } else if (c == '[') {
+            size_t j = i + 1;
+            bool negada = j < patron.size() && (patron[j] == '^' || patron[j] == '!');
+            if (negada) ++j;
+            // Un ']' justo después de '[' (o de '[^') es parte de la clase
+            bool primero = true;
+            while (j < patron.size() && (patron[j] != ']' || primero)) {
+                primero = false;
+                unsigned char desde = patron[j];
+                if (desde == '\\' && j + 1 < patron.size()) desde = patron[++j];
+                unsigned char hasta = desde;
+                if (j + 2 < patron.size() && patron[j + 1] == '-' && patron[j + 2] != ']') {
+                    j += 2;
+                    hasta = patron[j];
+                    if (hasta == '\\' && j + 1 < patron.size()) hasta = patron[++j];
+                    if (hasta < desde) {
+                        mensaje = "Rango no válido en la clase: " + string(patron.substr(i, j - i + 1));
+                        return;
+                    }
+                }
+                for (unsigned b = desde; b <= hasta; ++b) clase.set(b);
+                ++j;
+            }
+            if (j >= patron.size()) {
+                mensaje = "Falta el ']' que cierra la clase que empieza en la posición " + to_string(i + 1);
+                return;
+            }
+            // Con -i la clase acepta ambos casos de cada byte listado, y después se niega: [^a] no acepta 'A'
+            if (ignorarMayusculas) plegarClase(clase);
+            if (negada) clase.flip();
+            clase.reset('\n');
+            i = j;
+        } else {
+            if (c == '\\') {
+                if (i + 1 == patron.size()) {
+                    mensaje = "El patrón termina con '\\' sin un byte que escapar";
+                    return;
+                }
+                c = patron[++i];
+            }
+            if (c == '\n') {
+                mensaje = "Los patrones con comodines no pueden contener saltos de línea";
+                return;
+            }
+            clase.set(static_cast<unsigned char>(c));
+            literal = static_cast<unsigned char>(c);
+            if (ignorarMayusculas) plegarClase(clase);
+        }
+        segmentos.back().push_back(clase);
+        literales.back().push_back(literal);
+    }
+
+    // Un '*' al final deja un segmento vacío
+    if (segmentos.size() > 1 && segmentos.back().empty()) {
+        segmentos.pop_back();
+        literales.pop_back();
+    }
+    if (segmentos[0].empty()) {
+        mensaje = "El patrón no tiene ningún byte que buscar";
+        return;
+    }
+
+    // Factor literal obligatorio más largo: la secuencia más larga de elementos literales dentro de un segmento
+    size_t mejor_segmento = 0, mejor_inicio = 0, mejor_largo = 0;
+    for (size_t k = 0; k < literales.size(); ++k) {
+        size_t largo = 0;
+        for (size_t i = 0; i <= literales[k].size(); ++i) {
+            if (i < literales[k].size() && literales[k][i] >= 0) {
+                ++largo;
+                continue;
+            }
+            if (largo > mejor_largo) mejor_segmento = k, mejor_inicio = i - largo, mejor_largo = largo;
+            largo = 0;
+        }
+    }
+    if (mejor_largo == 0) return;
+
+    for (size_t i = 0; i < mejor_largo; ++i) factor_literal += static_cast<char>(literales[mejor_segmento][mejor_inicio + i]);
+    inicio_factor = mejor_inicio;
+
+    // Sin '*' la ventana candidata empieza inicio_factor bytes antes del factor; con '*' se verifica la línea
+    prefiltro.emplace(algoritmo, factor_literal, ignorarMayusculas);
+    if (!prefiltro->valido()) {
+        mensaje = "Algoritmo no reconocido para el prefiltro: " + algoritmo;
+        prefiltro.reset();
+    }
+}
@@ -0,0 +1,141 @@
+#ifndef COMODINES_HPP
+#define COMODINES_HPP
+
+#include <bitset>
+#include <cstdint>
+#include <cstring>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "patron_compilado.hpp"
+#include "resultados.hpp"
+
+/* Patrones con comodines (-w):
+     ?        cualquier byte
+     *        cualquier secuencia de bytes (también vacía)
+     [abc]    uno de los bytes de la clase; se admiten rangos ([a-z0-9]) y negación ([^0-9] o [!0-9])
+     \x       el byte x literal (para buscar ?, *, [ o \)
+   Las coincidencias nunca cruzan un salto de línea: ni los comodines ni las clases aceptan '\n', como en grep.
+   Un '*' al comienzo o al final no cambia dónde empiezan las coincidencias y se ignora.
+
+   Búsqueda: del patrón se extrae el factor literal obligatorio más largo y se busca con un algoritmo exacto
+   (PatronCompilado) como prefiltro. Solo alrededor de cada aparición del factor se verifica el patrón completo:
+   sin '*' la coincidencia tiene largo fijo y se verifica una sola ventana; con '*' se verifica la línea que
+   contiene el factor (una sola vez por línea). Así la búsqueda avanza a la velocidad del algoritmo exacto y la
+   verificación solo cuesta en las pocas zonas candidatas. Un patrón sin bytes literales se verifica en todo el texto. */
+class PatronComodin {
+public:
+    // 'algoritmo' es el algoritmo exacto del prefiltro (ver PatronCompilado).
+    // Si la sintaxis no es válida el patrón queda no válido y error() explica por qué.
+    explicit PatronComodin(std::string_view patron, const std::string &algoritmo = "Boyer-Moore",
+                           bool ignorarMayusculas = false);
+
+    bool valido() const { return mensaje.empty(); }
+    const std::string &error() const { return mensaje; }
+
+    // Largo de las coincidencias si el patrón no tiene '*' (0 si lo tiene: el largo es variable)
+    size_t largoFijo() const { return segmentos.size() == 1 ? segmentos[0].size() : 0; }
+
+    // Factor literal que se busca como prefiltro (vacío si el patrón no tiene bytes literales)
+    const std::string &factor() const { return factor_literal; }
+
+    template <class Sink>
+    void buscar(std::string_view texto, Sink &sink) const;
+
+private:
+    using Clase = std::bitset<256>;
+    using Segmento = std::vector<Clase>; // Parte del patrón entre dos '*', de largo fijo
+
+    static bool coincide(const Segmento &segmento, const char *texto) {
+        for (size_t i = 0; i < segmento.size(); ++i) {
+            if (!segmento[i][static_cast<unsigned char>(texto[i])]) return false;
+        }
+        return true;
+    }
+
+    template <class Sink>
+    bool buscarEnLinea(std::string_view linea, uint64_t base, Sink &sink) const;
+
+    std::vector<Segmento> segmentos;
+    std::string factor_literal;
+    size_t inicio_factor = 0;                  // Posición del factor dentro de su segmento
+    std::optional<PatronCompilado> prefiltro;  // Algoritmo exacto para el factor
+    std::string mensaje;                       // Error de sintaxis (vacío si el patrón es válido)
+};
+
+template <class Sink>
+void PatronComodin::buscar(std::string_view texto, Sink &sink) const {
+
+    if (!valido()) return;
+    size_t n = texto.size();
+    bool seguir = true;
+
+    // Sin '*': cada aparición del factor fija el inicio de la única ventana candidata
+    if (segmentos.size() == 1) {
+        const Segmento &patron = segmentos[0];
+        size_t m = patron.size();
+        if (n < m) return;
+        if (!prefiltro) {
+            for (size_t s = 0; s + m <= n; ++s) {
+                if (coincide(patron, texto.data() + s) && !sink.reportar(s)) return;
+            }
+            return;
+        }
+        auto candidatos = sinkFuncion([&](uint64_t pos) {
+            if (pos < inicio_factor || pos - inicio_factor + m > n) return true;
+            uint64_t s = pos - inicio_factor;
+            if (coincide(patron, texto.data() + s)) seguir = sink.reportar(s);
+            return seguir;
+        });
+        prefiltro->buscar(texto, candidatos);
+        return;
+    }
+
+    // Con '*': se verifica la línea de cada aparición del factor, saltando las que caen en una línea ya verificada
+    size_t verificado = 0; // Las posiciones anteriores a esta ya pertenecen a una línea verificada
+    auto verificarLinea = [&](uint64_t pos) {
+        if (pos < verificado) return true;
+        const void *salto_anterior = pos > 0 ? memrchr(texto.data(), '\n', pos) : nullptr;
+        size_t inicio = salto_anterior ? static_cast<const char *>(salto_anterior) - texto.data() + 1 : 0;
+        const void *salto_siguiente = memchr(texto.data() + pos, '\n', n - pos);
+        size_t fin = salto_siguiente ? static_cast<const char *>(salto_siguiente) - texto.data() : n;
+        verificado = fin + 1;
+        seguir = buscarEnLinea(texto.substr(inicio, fin - inicio), inicio, sink);
+        return seguir;
+    };
+    if (prefiltro) {
+        auto candidatos = sinkFuncion(verificarLinea);
+        prefiltro->buscar(texto, candidatos);
+    } else {
+        while (seguir && verificado < n) verificarLinea(verificado);
+    }
+}
+
+// Reporta los inicios de las coincidencias dentro de una línea (sin '\n'). Devuelve false si el sink pidió detenerse.
+template <class Sink>
+bool PatronComodin::buscarEnLinea(std::string_view linea, uint64_t base, Sink &sink) const {
+
+    // Los segmentos después del primero se ubican desde la derecha, cada uno en su última aparición antes del
+    // siguiente. 'limite' queda en la mayor posición donde puede terminar el primer segmento: hay coincidencia
+    // en s si y solo si el primer segmento coincide en s y termina a más tardar en 'limite'.
+    size_t limite = linea.size();
+    for (size_t k = segmentos.size() - 1; k >= 1; --k) {
+        const Segmento &segmento = segmentos[k];
+        if (limite < segmento.size()) return true;
+        size_t x = limite - segmento.size();
+        while (!coincide(segmento, linea.data() + x)) {
+            if (x == 0) return true;
+            --x;
+        }
+        limite = x;
+    }
+
+    const Segmento &primero = segmentos[0];
+    for (size_t s = 0; s + primero.size() <= limite; ++s) {
+        if (coincide(primero, linea.data() + s) && !sink.reportar(base + s)) return false;
+    }
+    return true;
+}
+
+#endif // COMODINES_HPP
@@ -0,0 +1,340 @@
+/* Construccion y consulta del indice FM.
+   El arreglo de sufijos se construye con SA-IS (Nong, Zhang y Chan) en tiempo lineal. Al texto se le agrega al final un centinela virtual menor que todos los bytes,
+   asi el corpus puede contener cualquier byte (incluido el separador "$" entre archivos).
+*/
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "fm_index.hpp"
+
+using namespace std;
+
+struct CabeceraFM {
+    char magia[8];
+    uint64_t n;               // Largo del texto (hay n + 1 filas contando el centinela)
+    uint64_t fila_fin;        // Fila del sufijo que empieza en 0: su byte de la BWT es el centinela
+    uint32_t intervalo_occ;
+    uint32_t paso_muestras;
+    uint64_t C[257];          // C[c] = filas cuyo sufijo empieza con un simbolo menor que c
+    uint64_t off_occ, off_marcas, off_rango, off_muestras, off_bwt; // Posicion de cada seccion en el archivo
+};
+
+namespace fm_index {
+    const char MAGIA[8] = {'F', 'M', 'I', 'N', 'D', 'E', 'X', '1'};
+
+    // SA-IS: ordena los sufijos de s (simbolos en [0, maximo]) en tiempo lineal.
+    // Clasifica cada sufijo como S (menor que el siguiente) o L (mayor), ordena primero los sufijos
+    // LMS (S precedidos por un L) y a partir de ellos induce el orden del resto. Si dos subcadenas LMS
+    // son iguales, se resuelve recursivamente sobre el texto reducido de sus nombres.
+    vector<int> sais(const vector<int> &s, int maximo) {
+        int n = s.size();
+        if (n == 0) return {};
+        if (n == 1) return {0};
+        if (n == 2) return s[0] < s[1] ? vector<int>{0, 1} : vector<int>{1, 0};
+
+        vector<int> sa(n);
+        vector<bool> tipoS(n, false);
+        for (int i = n - 2; i >= 0; i--) {
+            tipoS[i] = s[i] == s[i + 1] ? tipoS[i + 1] : s[i] < s[i + 1];
+        }
+
+        // Inicio de la zona L y de la zona S de cada simbolo en el arreglo de sufijos
+        vector<int> inicioL(maximo + 1, 0), inicioS(maximo + 1, 0);
+        for (int i = 0; i < n; i++) {
+            if (!tipoS[i]) inicioS[s[i]]++;
+            else if (s[i] < maximo) inicioL[s[i] + 1]++;
+        }
+        for (int c = 0; c <= maximo; c++) {
+            inicioS[c] += inicioL[c];
+            if (c < maximo) inicioL[c + 1] += inicioS[c];
+        }
+
+        auto inducir = [&](const vector<int> &lms) {
+            fill(sa.begin(), sa.end(), -1);
+            vector<int> cubeta(inicioS);
+            for (int d : lms) sa[cubeta[s[d]]++] = d;
+            // Los sufijos L se deducen de izquierda a derecha
+            cubeta = inicioL;
+            sa[cubeta[s[n - 1]]++] = n - 1;
+            for (int i = 0; i < n; i++) {
+                int v = sa[i];
+                if (v >= 1 && !tipoS[v - 1]) sa[cubeta[s[v - 1]]++] = v - 1;
+            }
+            // Los sufijos S se deducen de derecha a izquierda, llenando cada cubeta desde el final
+            cubeta = inicioL;
+            for (int i = n - 1; i >= 0; i--) {
+                int v = sa[i];
+                if (v >= 1 && tipoS[v - 1]) sa[--cubeta[s[v - 1] + 1]] = v - 1;
+            }
+        };
+
+        vector<int> indiceLMS(n + 1, -1);
+        vector<int> lms;
+        for (int i = 1; i < n; i++) {
+            if (!tipoS[i - 1] && tipoS[i]) {
+                indiceLMS[i] = lms.size();
+                lms.push_back(i);
+            }
+        }
+        int m = lms.size();
+
+        inducir(lms);
+        if (m == 0) return sa;
+
+        // Nombrar las subcadenas LMS en el orden inducido (iguales reciben el mismo nombre)
+        vector<int> lmsOrdenados;
+        lmsOrdenados.reserve(m);
+        for (int v : sa) {
+            if (indiceLMS[v] != -1) lmsOrdenados.push_back(v);
+        }
+        vector<int> reducido(m);
+        int nombre = 0;
+        reducido[indiceLMS[lmsOrdenados[0]]] = 0;
+        for (int i = 1; i < m; i++) {
+            int l = lmsOrdenados[i - 1], r = lmsOrdenados[i];
+            int finL = indiceLMS[l] + 1 < m ? lms[indiceLMS[l] + 1] : n;
+            int finR = indiceLMS[r] + 1 < m ? lms[indiceLMS[r] + 1] : n;
+            bool igual = true;
+            if (finL - l != finR - r) {
+                igual = false;
+            } else {
+                while (l < finL && s[l] == s[r]) {
+                    l++;
+                    r++;
+                }
+                if (l == n || s[l] != s[r]) igual = false;
+            }
+            if (!igual) nombre++;
+            reducido[indiceLMS[lmsOrdenados[i]]] = nombre;
+        }
+
+        // Ordenar el texto reducido y usar ese orden de los LMS para la induccion final
+        vector<int> saReducido = sais(reducido, nombre);
+        for (int i = 0; i < m; i++) lmsOrdenados[i] = lms[saReducido[i]];
+        inducir(lmsOrdenados);
+        return sa;
+    }
+
+    // Arreglo de sufijos de texto + centinela (n + 1 sufijos). El sufijo vacio (centinela) es el menor.
+    vector<uint32_t> arregloSufijos(string_view texto) {
+        vector<int> simbolos(texto.begin(), texto.end());
+        for (int &c : simbolos) c &= 0xFF;
+        vector<int> orden = sais(simbolos, 255);
+        simbolos.clear();
+        simbolos.shrink_to_fit();
+
+        vector<uint32_t> sa;
+        sa.reserve(texto.size() + 1);
+        sa.push_back(texto.size());
+        sa.insert(sa.end(), orden.begin(), orden.end());
+        return sa;
+    }
+
+    // Escribe ceros hasta que la posicion del archivo sea multiplo de 8
+    void alinear(ofstream &out) {
+        static const char ceros[8] = {};
+        out.write(ceros, (8 - out.tellp() % 8) % 8);
+    }
+}
+
+bool construirFMIndice(string_view texto, const string &ruta) {
+
+    // SA-IS ordena los sufijos con indices int, asi que el texto debe caber en un int32_t
+    if (texto.size() >= INT32_MAX) {
+        cerr << "El corpus es demasiado grande para el indice FM (maximo 2 GiB)." << endl;
+        return false;
+    }
+
+    uint64_t n = texto.size();
+    uint64_t filas = n + 1;
+    vector<uint32_t> sa = fm_index::arregloSufijos(texto);
+
+    CabeceraFM cab = {};
+    memcpy(cab.magia, fm_index::MAGIA, sizeof(cab.magia));
+    cab.n = n;
+    cab.intervalo_occ = FM_INTERVALO_OCC;
+    cab.paso_muestras = FM_PASO_MUESTRAS;
+
+    // BWT: el byte anterior a cada sufijo
+    vector<unsigned char> bwt(filas);
+    for (uint64_t i = 0; i < filas; i++) {
+        if (sa[i] == 0) {
+            cab.fila_fin = i;
+            bwt[i] = 0;
+        } else {
+            bwt[i] = texto[sa[i] - 1];
+        }
+    }
+
+    // C: la fila 0 es la del centinela, luego los sufijos ordenados por su primer byte
+    vector<uint64_t> frecuencia(256, 0);
+    for (char c : texto) frecuencia[static_cast<unsigned char>(c)]++;
+    cab.C[0] = 1;
+    for (int c = 0; c < 256; c++) cab.C[c + 1] = cab.C[c] + frecuencia[c];
+
+    // Tabla de ocurrencias muestreada cada FM_INTERVALO_OCC filas (sin contar la fila del centinela)
+    uint64_t puntos = filas / FM_INTERVALO_OCC + 1;
+    vector<uint32_t> tabla_occ(puntos * 256, 0);
+    vector<uint32_t> acumulado(256, 0);
+    for (uint64_t i = 0; i < filas; i++) {
+        if (i % FM_INTERVALO_OCC == 0) copy(acumulado.begin(), acumulado.end(), tabla_occ.begin() + (i / FM_INTERVALO_OCC) * 256);
+        if (i != cab.fila_fin) acumulado[bwt[i]]++;
+    }
+    if (filas % FM_INTERVALO_OCC == 0) copy(acumulado.begin(), acumulado.end(), tabla_occ.begin() + (filas / FM_INTERVALO_OCC) * 256);
+
+    // Muestras del arreglo de sufijos: filas cuya posicion es multiplo de FM_PASO_MUESTRAS
+    uint64_t palabras = filas / 64 + 1;
+    vector<uint64_t> marcas(palabras, 0);
+    vector<uint32_t> rango_marcas(palabras, 0);
+    vector<uint32_t> muestras;
+    for (uint64_t i = 0; i < filas; i++) {
+        if (sa[i] % FM_PASO_MUESTRAS == 0) {
+            marcas[i / 64] |= 1ULL << (i % 64);
+            muestras.push_back(sa[i]);
+        }
+    }
+    for (uint64_t w = 1; w < palabras; w++) {
+        rango_marcas[w] = rango_marcas[w - 1] + __builtin_popcountll(marcas[w - 1]);
+    }
+    sa.clear();
+    sa.shrink_to_fit();
+
+    ofstream out(ruta, ios::binary);
+    if (!out.is_open()) {
+        cerr << "Error al crear el archivo del indice: " << ruta << endl;
+        return false;
+    }
+
+    // Escribir cada seccion alineada a 8 bytes y guardar su posicion en la cabecera
+    out.write(reinterpret_cast<const char *>(&cab), sizeof(cab));
+    fm_index::alinear(out);
+    cab.off_occ = out.tellp();
+    out.write(reinterpret_cast<const char *>(tabla_occ.data()), tabla_occ.size() * sizeof(uint32_t));
+    fm_index::alinear(out);
+    cab.off_marcas = out.tellp();
+    out.write(reinterpret_cast<const char *>(marcas.data()), marcas.size() * sizeof(uint64_t));
+    cab.off_rango = out.tellp();
+    out.write(reinterpret_cast<const char *>(rango_marcas.data()), rango_marcas.size() * sizeof(uint32_t));
+    fm_index::alinear(out);
+    cab.off_muestras = out.tellp();
+    out.write(reinterpret_cast<const char *>(muestras.data()), muestras.size() * sizeof(uint32_t));
+    fm_index::alinear(out);
+    cab.off_bwt = out.tellp();
+    out.write(reinterpret_cast<const char *>(bwt.data()), bwt.size());
+
+    out.seekp(0);
+    out.write(reinterpret_cast<const char *>(&cab), sizeof(cab));
+    out.close();
+    return !out.fail();
+}
+
+FMIndice::~FMIndice() {
+    if (mapa != nullptr) munmap(mapa, largo_mapa);
+}
+
+bool FMIndice::abrir(const string &ruta) {
+
+    int fd = open(ruta.c_str(), O_RDONLY);
+    if (fd < 0) {
+        cerr << "Error al abrir el indice: " << ruta << endl;
+        return false;
+    }
+
+    struct stat info;
+    if (fstat(fd, &info) < 0 || static_cast<size_t>(info.st_size) < sizeof(CabeceraFM)) {
+        cerr << "Indice invalido: " << ruta << endl;
+        close(fd);
+        return false;
+    }
+
+    mapa = mmap(nullptr, info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (mapa == MAP_FAILED) {
+        mapa = nullptr;
+        cerr << "Error al mapear el indice: " << ruta << endl;
+        return false;
+    }
+    largo_mapa = info.st_size;
+
+    const char *base = static_cast<const char *>(mapa);
+    cab = reinterpret_cast<const CabeceraFM *>(base);
+    if (memcmp(cab->magia, fm_index::MAGIA, sizeof(cab->magia)) != 0 || cab->off_bwt + cab->n + 1 > largo_mapa) {
+        cerr << "Indice invalido: " << ruta << endl;
+        return false;
+    }
+
+    tabla_occ = reinterpret_cast<const uint32_t *>(base + cab->off_occ);
+    marcas = reinterpret_cast<const uint64_t *>(base + cab->off_marcas);
+    rango_marcas = reinterpret_cast<const uint32_t *>(base + cab->off_rango);
+    muestras = reinterpret_cast<const uint32_t *>(base + cab->off_muestras);
+    bwt = reinterpret_cast<const unsigned char *>(base + cab->off_bwt);
+    return true;
+}
+
+uint64_t FMIndice::largoTexto() const {
+    return cab->n;
+}
+
+uint64_t FMIndice::occ(unsigned char c, uint64_t fila) const {
+    uint64_t punto = fila / cab->intervalo_occ;
+    uint64_t total = tabla_occ[punto * 256 + c];
+    // Contar el resto desde el ultimo punto muestreado
+    for (uint64_t i = punto * cab->intervalo_occ; i < fila; i++) {
+        total += bwt[i] == c && i != cab->fila_fin;
+    }
+    return total;
+}
+
+bool FMIndice::rango(string_view patron, uint64_t *inicio, uint64_t *fin) const {
+    // Busqueda hacia atras: se agrega un byte del patron por vez, de derecha a izquierda
+    uint64_t sp = 0, ep = cab->n + 1;
+    for (size_t i = patron.size(); i-- > 0 && sp < ep; ) {
+        unsigned char c = patron[i];
+        sp = cab->C[c] + occ(c, sp);
+        ep = cab->C[c] + occ(c, ep);
+    }
+    *inicio = sp;
+    *fin = ep;
+    return sp < ep;
+}
+
+uint64_t FMIndice::lf(uint64_t fila) const {
+    unsigned char c = bwt[fila];
+    return cab->C[c] + occ(c, fila);
+}
+
+uint64_t FMIndice::posicion(uint64_t fila) const {
+    // Retroceder en el texto hasta una posicion muestreada (a lo mas paso_muestras - 1 pasos)
+    uint64_t pasos = 0;
+    while (!((marcas[fila / 64] >> (fila % 64)) & 1)) {
+        fila = lf(fila);
+        pasos++;
+    }
+    uint64_t antes = marcas[fila / 64] & ((1ULL << (fila % 64)) - 1);
+    return muestras[rango_marcas[fila / 64] + __builtin_popcountll(antes)] + pasos;
+}
+
+uint64_t FMIndice::contar(string_view patron) const {
+    uint64_t inicio, fin;
+    if (patron.empty() || !rango(patron, &inicio, &fin)) return 0;
+    return fin - inicio;
+}
+
+vector<uint64_t> FMIndice::ubicar(string_view patron) const {
+    vector<uint64_t> posiciones;
+    uint64_t inicio, fin;
+    if (patron.empty() || !rango(patron, &inicio, &fin)) return posiciones;
+
+    posiciones.reserve(fin - inicio);
+    for (uint64_t fila = inicio; fila < fin; fila++) {
+        posiciones.push_back(posicion(fila));
+    }
+    sort(posiciones.begin(), posiciones.end());
+    return posiciones;
+}
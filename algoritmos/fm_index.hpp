@@ -0,0 +1,55 @@
+#ifndef FM_INDEX_HPP
+#define FM_INDEX_HPP
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+/* Indice FM sobre un corpus: transformada de Burrows-Wheeler del texto, tabla de ocurrencias
+   muestreada cada FM_INTERVALO_OCC filas y arreglo de sufijos muestreado cada FM_PASO_MUESTRAS
+   posiciones del texto. Ocupa ~5.4 bytes por byte de texto y no necesita el texto original:
+   contar un patron cuesta O(m) y ubicar sus ocurrencias O(m + occ * FM_PASO_MUESTRAS). */
+
+constexpr uint32_t FM_INTERVALO_OCC = 256;
+constexpr uint32_t FM_PASO_MUESTRAS = 32;
+
+struct CabeceraFM; // Formato del archivo, definido en fm_index.cpp
+
+// Construye el indice del texto y lo escribe en 'ruta'. El texto debe medir menos de 2 GiB
+// (INT32_MAX bytes, porque SA-IS usa indices int).
+bool construirFMIndice(std::string_view texto, const std::string &ruta);
+
+// Indice FM mapeado en memoria (solo lectura)
+class FMIndice {
+public:
+    FMIndice() = default;
+    ~FMIndice();
+    FMIndice(const FMIndice &) = delete;
+    FMIndice &operator=(const FMIndice &) = delete;
+
+    bool abrir(const std::string &ruta);
+
+    uint64_t contar(std::string_view patron) const;
+    std::vector<uint64_t> ubicar(std::string_view patron) const; // Posiciones ordenadas
+    uint64_t largoTexto() const;
+
+private:
+    // Ocurrencias del byte c en las filas [0, fila) de la BWT
+    uint64_t occ(unsigned char c, uint64_t fila) const;
+    // Rango [inicio, fin) de filas cuyos sufijos empiezan con el patron
+    bool rango(std::string_view patron, uint64_t *inicio, uint64_t *fin) const;
+    uint64_t lf(uint64_t fila) const;
+    uint64_t posicion(uint64_t fila) const;
+
+    void *mapa = nullptr;
+    size_t largo_mapa = 0;
+    const CabeceraFM *cab = nullptr;
+    const uint32_t *tabla_occ = nullptr;
+    const uint64_t *marcas = nullptr;    // Bit por fila: 1 si su posicion del texto esta muestreada
+    const uint32_t *rango_marcas = nullptr;
+    const uint32_t *muestras = nullptr;
+    const unsigned char *bwt = nullptr;
+};
+
+#endif // FM_INDEX_HPP
@@ -0,0 +1,34 @@
+#include "patron_compilado.hpp"
+
+using namespace std;
+
+// Construye las tablas del algoritmo pedido. Los algoritmos guiados por tablas reciben ignorarMayusculas
+// al construirlas; KMP, Robin-Karp y SIMD eligen la instancia con o sin plegado.
+PatronCompilado::PatronCompilado(const string &algoritmo, string_view patron, bool ignorarMayusculas,
+                                 atomic<uint64_t> *colisiones)
+    : nombre(algoritmo), largo_patron(patron.size()), colisiones(colisiones) {
+
+    if (algoritmo == "Boyer-Moore") {
+        motor.emplace<BoyerMoore>(patron, ignorarMayusculas);
+    } else if (algoritmo == "Horspool") {
+        motor.emplace<Horspool>(Horspool{BoyerMoore(patron, ignorarMayusculas)});
+    } else if (algoritmo == "KMP" || (algoritmo == "KMP-DFA" && patron.size() > LARGO_MAXIMO_AUTOMATA)) {
+        // Sobre LARGO_MAXIMO_AUTOMATA la tabla del autómata sería muy grande, se usa la tabla de fallos
+        if (ignorarMayusculas) motor.emplace<KMPCompilado<SinMayusculas>>(patron);
+        else motor.emplace<KMPCompilado<Exacto>>(patron);
+    } else if (algoritmo == "KMP-DFA") {
+        if (patron.size() <= 8) motor.emplace<AutomataKMP<8>>(patron, ignorarMayusculas);
+        else if (patron.size() <= 16) motor.emplace<AutomataKMP<16>>(patron, ignorarMayusculas);
+        else motor.emplace<AutomataKMP<0>>(patron, ignorarMayusculas);
+    } else if (algoritmo == "Robin-Karp") {
+        if (ignorarMayusculas) motor.emplace<RobinKarpCompilado<SinMayusculas>>(patron);
+        else motor.emplace<RobinKarpCompilado<Exacto>>(patron);
+    } else if (algoritmo == "SIMD") {
+        if (ignorarMayusculas) motor.emplace<SimdCompilado<SinMayusculas>>(patron);
+        else motor.emplace<SimdCompilado<Exacto>>(patron);
+    } else if (algoritmo == "Shift-Or") {
+        motor.emplace<ShiftOr>(patron, ignorarMayusculas);
+    } else if (algoritmo == "BNDM") {
+        motor.emplace<BNDM>(patron, ignorarMayusculas);
+    }
+}
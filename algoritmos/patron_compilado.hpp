@@ -0,0 +1,79 @@
+#ifndef PATRON_COMPILADO_HPP
+#define PATRON_COMPILADO_HPP
+
+#include <atomic>
+#include <cstdint>
+#include <iterator>
+#include <string>
+#include <string_view>
+#include <variant>
+#include "boyer_moore.hpp"
+#include "KMP.hpp"
+#include "robin_karp.hpp"
+#include "simd.hpp"
+#include "bit_paralelo.hpp"
+#include "resultados.hpp"
+
+/* Patrón compilado para uno de los algoritmos de un patrón (API de la biblioteca libpatrones.a).
+   Las tablas del algoritmo (saltos de Boyer-Moore, fallos de KMP, autómata, hash de Robin-Karp, máscaras de
+   bits) se calculan una sola vez al construirlo; buscar no reserva memoria, así que el mismo objeto se usa
+   para buscar en muchos archivos o trozos, también desde varios hilos a la vez. (La única excepción es Shift-Or
+   con patrones de más de 1024 bytes, cuyo estado va en un buffer por hilo que se reserva la primera vez.)
+   buscar es una plantilla sobre el texto (cualquier rango contiguo de char: string, string_view, vector<char>,
+   una región mapeada, ...) y sobre el sink de resultados (ver resultados.hpp), por lo que el algoritmo se
+   instancia con el sink concreto y no hay llamadas indirectas dentro del ciclo de búsqueda.
+
+       PatronCompilado patron("Boyer-Moore", "error");
+       SinkConteo sink;
+       for (const string &archivo : archivos) patron.buscar(archivo, sink);
+*/
+class PatronCompilado {
+public:
+    // Con un algoritmo no reconocido el patrón queda no válido (ver valido()) y buscar no encuentra nada.
+    // Con ignorarMayusculas no se distinguen mayúsculas de minúsculas (ver plegado.hpp).
+    // Robin-Karp suma a 'colisiones' (si no es nulo) sus coincidencias falsas de hash.
+    PatronCompilado(const std::string &algoritmo, std::string_view patron, bool ignorarMayusculas = false,
+                    std::atomic<uint64_t> *colisiones = nullptr);
+
+    bool valido() const { return !std::holds_alternative<std::monostate>(motor); }
+    const std::string &algoritmo() const { return nombre; }
+    size_t largo() const { return largo_patron; }
+
+    template <class Texto, class Sink>
+    void buscar(const Texto &texto, Sink &sink) const {
+        std::string_view vista(std::data(texto), std::size(texto));
+        std::visit([&](const auto &m) { buscarCon(m, vista, sink); }, motor);
+    }
+
+private:
+    // Horspool usa las mismas tablas que Boyer-Moore, pero otra búsqueda
+    struct Horspool {
+        BoyerMoore bm;
+    };
+
+    template <class Sink>
+    static void buscarCon(const std::monostate &, std::string_view, Sink &) {}
+
+    template <class Motor, class Sink>
+    static void buscarCon(const Motor &m, std::string_view texto, Sink &sink) { m.buscar(texto, sink); }
+
+    template <class Sink>
+    static void buscarCon(const Horspool &h, std::string_view texto, Sink &sink) { h.bm.buscarHorspool(texto, sink); }
+
+    template <class Plegar, class Sink>
+    void buscarCon(const RobinKarpCompilado<Plegar> &rk, std::string_view texto, Sink &sink) const {
+        uint64_t falsas = 0;
+        rk.buscar(texto, sink, &falsas);
+        if (colisiones != nullptr) *colisiones += falsas;
+    }
+
+    std::string nombre;
+    size_t largo_patron;
+    std::atomic<uint64_t> *colisiones;
+    std::variant<std::monostate, BoyerMoore, Horspool, KMPCompilado<Exacto>, KMPCompilado<SinMayusculas>,
+                 AutomataKMP<8>, AutomataKMP<16>, AutomataKMP<0>, RobinKarpCompilado<Exacto>,
+                 RobinKarpCompilado<SinMayusculas>, SimdCompilado<Exacto>, SimdCompilado<SinMayusculas>, ShiftOr, BNDM>
+        motor;
+};
+
+#endif // PATRON_COMPILADO_HPP
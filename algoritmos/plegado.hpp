@@ -0,0 +1,67 @@
+#ifndef PLEGADO_HPP
+#define PLEGADO_HPP
+
+#include <array>
+#include <cstring>
+#include <string>
+#include <string_view>
+
+/* Plegado de mayúsculas para la búsqueda que no distingue mayúsculas de minúsculas (-i).
+   TABLA_PLEGADO lleva cada byte a su representante (A-Z a a-z); el resto de los bytes queda igual, así que
+   los caracteres UTF-8 de varios bytes (ñ, á, ...) se siguen comparando exactos.
+   El patrón se pliega una sola vez y el texto se pliega byte a byte al compararlo, sin copiarlo.
+   Los algoritmos son plantillas sobre el plegado: con Exacto las comparaciones quedan como antes (memcmp
+   incluido), y los algoritmos guiados por tablas (autómatas, máscaras, saltos) no lo usan en el ciclo de
+   búsqueda, porque la fila de cada mayúscula se copia de la de su minúscula al construir la tabla. */
+inline constexpr std::array<unsigned char, 256> TABLA_PLEGADO = [] {
+    std::array<unsigned char, 256> tabla{};
+    for (int c = 0; c < 256; ++c) tabla[c] = (c >= 'A' && c <= 'Z') ? c - 'A' + 'a' : c;
+    return tabla;
+}();
+
+// Distingue mayúsculas de minúsculas (búsqueda por defecto)
+struct Exacto {
+    static constexpr bool activo = false;
+    unsigned char operator()(char c) const { return static_cast<unsigned char>(c); }
+};
+
+// No distingue mayúsculas de minúsculas (-i)
+struct SinMayusculas {
+    static constexpr bool activo = true;
+    unsigned char operator()(char c) const { return TABLA_PLEGADO[static_cast<unsigned char>(c)]; }
+    // El otro byte con el mismo representante (la mayúscula de una letra), o el mismo byte si no hay
+    static unsigned char otro(unsigned char c) { return (c >= 'a' && c <= 'z') ? c - 'a' + 'A' : c; }
+};
+
+// Copia plegada del patrón
+inline std::string plegar(std::string_view texto) {
+    std::string plegado(texto);
+    for (char &c : plegado) c = static_cast<char>(TABLA_PLEGADO[static_cast<unsigned char>(c)]);
+    return plegado;
+}
+
+// Compara n bytes del texto con el patrón ya plegado
+template <class Plegar>
+inline bool iguales(const char *texto, const char *patron, size_t n, Plegar plegar) {
+    if constexpr (!Plegar::activo) {
+        return std::memcmp(texto, patron, n) == 0;
+    } else {
+        for (size_t i = 0; i < n; ++i) {
+            if (plegar(texto[i]) != static_cast<unsigned char>(patron[i])) return false;
+        }
+        return true;
+    }
+}
+
+// Copia en cada byte de 'tabla' (indexada por byte, de a 'ancho' entradas) la fila de su representante,
+// así una búsqueda guiada por la tabla trata igual la mayúscula y la minúscula sin plegar el texto
+template <class Tabla>
+inline void extenderPlegado(Tabla &tabla, size_t ancho = 1, size_t base = 0) {
+    for (size_t c = 0; c < 256; ++c) {
+        size_t r = TABLA_PLEGADO[c];
+        if (r == c) continue;
+        for (size_t k = 0; k < ancho; ++k) tabla[base + c * ancho + k] = tabla[base + r * ancho + k];
+    }
+}
+
+#endif // PLEGADO_HPP
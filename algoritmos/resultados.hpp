@@ -0,0 +1,91 @@
+#ifndef RESULTADOS_HPP
+#define RESULTADOS_HPP
+
+#include <cstdint>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+/* Modos de resultado de los algoritmos (sinks).
+   Los algoritmos son plantillas sobre el sink: por cada coincidencia llaman a sink.reportar(posicion)
+   y se detienen si devuelve false. Como el tipo del sink se conoce al compilar, la llamada se
+   inserta directamente en el ciclo de búsqueda y el modo que no guarda posiciones no reserva memoria.
+   Las posiciones son de 64 bits para corpus de más de 2 GiB. */
+
+// Guarda todas las posiciones
+struct SinkPosiciones {
+    std::vector<uint64_t> *posiciones;
+    bool reportar(uint64_t pos) {
+        posiciones->push_back(pos);
+        return true;
+    }
+};
+
+// Solo cuenta las coincidencias, sin reservar memoria
+struct SinkConteo {
+    uint64_t cantidad = 0;
+    bool reportar(uint64_t) {
+        cantidad++;
+        return true;
+    }
+};
+
+// Se detiene en la primera coincidencia
+struct SinkPrimera {
+    bool encontrada = false;
+    uint64_t posicion = 0;
+    bool reportar(uint64_t pos) {
+        encontrada = true;
+        posicion = pos;
+        return false;
+    }
+};
+
+// Entrega cada coincidencia a una función a medida que se encuentra (la función decide si seguir)
+template <class Funcion>
+struct SinkFuncion {
+    Funcion funcion;
+    bool reportar(uint64_t pos) {
+        return funcion(pos);
+    }
+};
+
+template <class Funcion>
+SinkFuncion<Funcion> sinkFuncion(Funcion funcion) {
+    return SinkFuncion<Funcion>{funcion};
+}
+
+/* Estadísticas de la búsqueda (--stats).
+   Los algoritmos anotan sus contadores con anotar(sink, campo, n). Solo el sink SinkEstadisticas tiene
+   un miembro 'estadisticas'; con los demás sinks anotar no hace nada al compilar (if constexpr), así que
+   la búsqueda normal no paga ningún costo en los ciclos internos. */
+struct Estadisticas {
+    uint64_t comparaciones = 0;         // Bytes del texto comparados con el patrón
+    uint64_t desplazamientos = 0;       // Veces que se desplazó la ventana
+    uint64_t total_desplazado = 0;      // Suma de los desplazamientos (bytes)
+    uint64_t transiciones_fallo = 0;    // Transiciones por la tabla de fallos (KMP)
+    uint64_t colisiones_hash = 0;       // Hashes iguales con texto distinto (Robin-Karp)
+    uint64_t coincidencias = 0;
+};
+
+template <class Sink, class = void>
+struct MideEstadisticas : std::false_type {};
+
+template <class Sink>
+struct MideEstadisticas<Sink, std::void_t<decltype(std::declval<Sink &>().estadisticas)>> : std::true_type {};
+
+template <class Sink>
+inline void anotar(Sink &sink, uint64_t Estadisticas::*campo, uint64_t n = 1) {
+    if constexpr (MideEstadisticas<Sink>::value) sink.estadisticas.*campo += n;
+}
+
+// Cuenta las coincidencias y recibe los contadores de los algoritmos
+struct SinkEstadisticas {
+    Estadisticas estadisticas;
+    bool reportar(uint64_t) {
+        estadisticas.coincidencias++;
+        return true;
+    }
+};
+
+#endif // RESULTADOS_HPP
@@ -1,60 +1,102 @@
+#include <cstring>
 #include <vector>
 #include <string>
+#include <string_view>
+#include <unordered_map>
+#include <map>
 #include "robin_karp.hpp"
 
 using namespace std;
 
-namespace robin_karp {
-    constexpr int prime = 101;    // Número primo para el cálculo del hash
-    constexpr int d = 256;        // Número de caracteres en el alfabeto
-
-    // Función para calcular el hash de un patrón
-    long long hash(const string &str, int length) {
-        long long h = 0;
-        for (int i = 0; i < length; i++) {
-            h = (static_cast<long long>(d) * h + str[i]) % prime;
-        }
-        return h;
-    }
+// Función para buscar un patrón en un texto usando el algoritmo de Robin-Karp
+vector<uint64_t> robinKarp(string_view text, string_view pattern, uint64_t *colisiones) {
+    vector<uint64_t> result;
+    SinkPosiciones sink{&result};
+    robinKarp(text, pattern, sink, colisiones);
+    return result;
 }
 
-// Función para buscar un patrón en un texto usando el algoritmo de Robin-Karp
-vector<int> robinKarp(const string &text, const string &pattern) {
-    vector<int> result;
-    int n = text.length();
-    int m = pattern.length();
-    if (m == 0 || n < m) return result;
-
-    long long patternHash = robin_karp::hash(pattern, m);
-    long long textHash = robin_karp::hash(text, m);
-
-    // Calcular el valor de h para el último carácter del patrón
-    long long h = 1;
-    for (int i = 0; i < m - 1; i++) {
-        h = (h * robin_karp::d) % robin_karp::prime;
+vector<vector<uint64_t>> robinKarpMultiple(string_view text, const vector<string> &patterns, uint64_t *colisiones) {
+    vector<vector<uint64_t>> result(patterns.size());
+    size_t n = text.length();
+
+    // Agrupar los patrones por largo: cada grupo necesita su propia ventana rodante
+    map<size_t, vector<int>> por_largo;
+    for (size_t p = 0; p < patterns.size(); p++) {
+        if (!patterns[p].empty() && patterns[p].size() <= n) por_largo[patterns[p].size()].push_back(p);
     }
 
-    for (int i = 0; i <= n - m; i++) {
-        if (patternHash == textHash) {
-            // Comparar caracteres.
-            bool match = true;
-            for (int j = 0; j < m; j++) {
-                if (text[i + j] != pattern[j]) {
-                    match = false;
-                    break;
+    for (const auto &[m, grupo] : por_largo) {
+        // Tabla hash -> patrones con ese hash (los patrones repetidos comparten entrada)
+        unordered_map<uint64_t, vector<int>> tabla;
+        for (int p : grupo) tabla[robin_karp::hash(patterns[p], m)].push_back(p);
+
+        // Filtro de bits para descartar la mayoría de las ventanas sin consultar la tabla
+        vector<bool> filtro(1 << 16, false);
+        for (const auto &entrada : tabla) filtro[entrada.first & 0xFFFF] = true;
+
+        uint64_t textHash = robin_karp::hash(text, m);
+        uint64_t h = robin_karp::peso(m);
+
+        for (size_t i = 0; i <= n - m; i++) {
+            if (filtro[textHash & 0xFFFF]) {
+                auto it = tabla.find(textHash);
+                if (it != tabla.end()) {
+                    bool alguno = false;
+                    for (int p : it->second) {
+                        if (text.compare(i, m, patterns[p]) == 0) {
+                            result[p].push_back(i);
+                            alguno = true;
+                        }
+                    }
+                    if (!alguno && colisiones != nullptr) (*colisiones)++;
                 }
             }
-            if (match) {
-                result.push_back(i);
+            if (i < n - m) {
+                textHash = robin_karp::rodar(textHash, text[i], text[i + m], h);
             }
         }
-        // Calcular el hash del siguiente substring
-        if (i < n - m) {
-            textHash = (robin_karp::d * (textHash - text[i] * h) + text[i + m]) % robin_karp::prime;
-            if (textHash < 0) {
-                textHash += robin_karp::prime; // Asegurar que el hash sea positivo
+    }
+    return result;
+}
+
+RobinKarpFlujo::RobinKarpFlujo(string_view pattern, bool ignorarMayusculas)
+    : pattern(ignorarMayusculas ? plegar(pattern) : string(pattern)), ignorarMayusculas(ignorarMayusculas),
+      ventana(pattern.size(), 0) {
+    patternHash = robin_karp::hash(this->pattern, this->pattern.size());
+    h = robin_karp::peso(pattern.size());
+}
+
+void RobinKarpFlujo::reiniciar() {
+    textHash = 0;
+    procesados = 0;
+    slot = 0;
+}
+
+void RobinKarpFlujo::alimentar(string_view bloque, const function<void(uint64_t)> &reportar) {
+    size_t m = pattern.size();
+    if (m == 0) return;
+
+    for (size_t i = 0; i < bloque.size(); i++) {
+        unsigned char entra = ignorarMayusculas ? TABLA_PLEGADO[static_cast<unsigned char>(bloque[i])] : bloque[i];
+
+        // Sacar el byte más antiguo (solo si la ventana ya estaba llena) y agregar el nuevo en su lugar
+        if (procesados >= m) {
+            textHash = robin_karp::restar(textHash, robin_karp::mult(ventana[slot], h));
+        }
+        textHash = robin_karp::sumar(robin_karp::mult(robin_karp::d, textHash), entra);
+        ventana[slot] = entra;
+        procesados++;
+        if (++slot == m) slot = 0; // El índice da la vuelta sin la división de procesados % m en cada byte
+
+        if (procesados >= m && textHash == patternHash) {
+            // Comparar caracteres; el byte más antiguo ahora está en slot, así que la ventana es
+            // ventana[slot, m) seguida de ventana[0, slot)
+            const char *p = pattern.data();
+            bool match = memcmp(ventana.data() + slot, p, m - slot) == 0 && memcmp(ventana.data(), p + m - slot, slot) == 0;
+            if (match) {
+                reportar(procesados - m);
             }
         }
     }
-    return result;
-}
\ No newline at end of file
+}
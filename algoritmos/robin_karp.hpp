@@ -1,11 +1,150 @@
 #ifndef ROBIN_KARP_HPP
 #define ROBIN_KARP_HPP
 
+#include <cstdint>
+#include <functional>
 #include <string>
+#include <string_view>
 #include <vector>
+#include "plegado.hpp"
+#include "resultados.hpp"
 
 using namespace std;
 
-vector<int> robinKarp(const string &text, const string &pattern);
+namespace robin_karp {
+    // Primo de Mersenne 2^61 - 1: el módulo se calcula con sumas y desplazamientos, y con un hash
+    // de 61 bits la probabilidad de colisión por ventana es del orden de m / 2^61 (despreciable)
+    constexpr uint64_t prime = (1ULL << 61) - 1;
+    constexpr uint64_t d = 1000003;   // Base del hash, mayor que el alfabeto (256 bytes)
+
+    // (a * b) % prime sin desbordar, usando un producto de 128 bits
+    inline uint64_t mult(uint64_t a, uint64_t b) {
+        __uint128_t p = static_cast<__uint128_t>(a) * b;
+        uint64_t r = (static_cast<uint64_t>(p) & prime) + static_cast<uint64_t>(p >> 61);
+        return r >= prime ? r - prime : r;
+    }
+
+    inline uint64_t sumar(uint64_t a, uint64_t b) {
+        uint64_t r = a + b;
+        return r >= prime ? r - prime : r;
+    }
+
+    inline uint64_t restar(uint64_t a, uint64_t b) {
+        return a >= b ? a - b : a + prime - b;
+    }
+
+    // Los bytes se leen sin signo para que los caracteres no ASCII no queden negativos
+    inline uint64_t byte(char c) {
+        return static_cast<unsigned char>(c);
+    }
+
+    // Función para calcular el hash de un patrón (de sus bytes plegados con 'plegar')
+    template <class Plegar = Exacto>
+    inline uint64_t hash(string_view str, size_t length, Plegar plegar = Plegar()) {
+        uint64_t h = 0;
+        for (size_t i = 0; i < length; i++) {
+            h = sumar(mult(d, h), plegar(str[i]));
+        }
+        return h;
+    }
+
+    // d^(m-1) % prime: peso del byte que sale de la ventana
+    inline uint64_t peso(size_t m) {
+        uint64_t h = 1;
+        for (size_t i = 0; i + 1 < m; i++) {
+            h = mult(h, d);
+        }
+        return h;
+    }
+
+    // Hash de la ventana siguiente: se saca el byte 'sale' y se agrega el byte 'entra'
+    inline uint64_t rodar(uint64_t textHash, char sale, char entra, uint64_t h) {
+        return sumar(mult(d, restar(textHash, mult(byte(sale), h))), byte(entra));
+    }
+}
+
+// Hash rodante de 64 bits módulo el primo de Mersenne 2^61 - 1. El hash del patrón y el peso del byte que
+// sale de la ventana se calculan una sola vez al construir el objeto, y buscar no reserva memoria.
+// Si 'colisiones' no es nulo, se le suman las ventanas cuyo hash coincide con el del patrón pero el texto
+// no (coincidencias falsas). Cada coincidencia se entrega al sink (ver resultados.hpp).
+// Con SinMayusculas el patrón se pliega al construirlo y el hash del texto se calcula con los bytes plegados.
+template <class Plegar = Exacto>
+class RobinKarpCompilado {
+public:
+    explicit RobinKarpCompilado(string_view patron)
+        : pattern(Plegar::activo ? plegar(patron) : string(patron)),
+          patternHash(robin_karp::hash(pattern, pattern.size())), h(robin_karp::peso(pattern.size())) {}
+
+    template <class Sink>
+    void buscar(string_view text, Sink &sink, uint64_t *colisiones = nullptr) const;
+
+    size_t largo() const { return pattern.size(); }
+
+private:
+    string pattern;
+    uint64_t patternHash;
+    uint64_t h; // d^(m-1) % prime, peso del byte que sale de la ventana
+};
+
+template <class Plegar>
+template <class Sink>
+void RobinKarpCompilado<Plegar>::buscar(string_view text, Sink &sink, uint64_t *colisiones) const {
+    size_t n = text.length();
+    size_t m = pattern.length();
+    if (m == 0 || n < m) return;
+
+    Plegar plegar;
+    uint64_t textHash = robin_karp::hash(text, m, plegar);
+
+    for (size_t i = 0; i <= n - m; i++) {
+        if (patternHash == textHash) {
+            // Comparar caracteres.
+            anotar(sink, &Estadisticas::comparaciones, m);
+            if (iguales(text.data() + i, pattern.data(), m, plegar)) {
+                if (!sink.reportar(i)) return;
+            } else {
+                if (colisiones != nullptr) (*colisiones)++;
+                anotar(sink, &Estadisticas::colisiones_hash);
+            }
+        }
+        // Calcular el hash del siguiente substring
+        if (i < n - m) {
+            textHash = robin_karp::rodar(textHash, plegar(text[i]), plegar(text[i + m]), h);
+        }
+    }
+}
+
+// Compila el patrón y lo busca una vez (para buscar el mismo patrón varias veces usar RobinKarpCompilado)
+template <class Sink>
+void robinKarp(string_view text, string_view pattern, Sink &sink, uint64_t *colisiones = nullptr) {
+    RobinKarpCompilado<>(pattern).buscar(text, sink, colisiones);
+}
+
+vector<uint64_t> robinKarp(string_view text, string_view pattern, uint64_t *colisiones = nullptr);
+
+// Busca varios patrones en una sola pasada por cada largo distinto: los hashes de los patrones
+// del mismo largo se guardan en una tabla hash y cada ventana del texto se consulta en ella.
+// Devuelve las posiciones de cada patrón, en el mismo orden de entrada.
+vector<vector<uint64_t>> robinKarpMultiple(string_view text, const vector<string> &patterns, uint64_t *colisiones = nullptr);
+
+// Robin-Karp para flujos: el hash rodante y una ventana circular con los últimos m bytes
+// se conservan entre bloques, por lo que usa memoria O(m) sin importar el largo del flujo.
+// Las posiciones reportadas son absolutas dentro del flujo (64 bits).
+class RobinKarpFlujo {
+public:
+    explicit RobinKarpFlujo(string_view pattern, bool ignorarMayusculas = false);
+    void alimentar(string_view bloque, const function<void(uint64_t)> &reportar);
+    void reiniciar(); // Volver al inicio de un flujo nuevo, conservando el hash del patrón
+
+private:
+    string pattern;             // Patrón (plegado si ignorarMayusculas)
+    bool ignorarMayusculas;
+    uint64_t patternHash = 0;
+    uint64_t h = 1;             // d^(m-1) % prime, peso del byte que sale de la ventana
+    uint64_t textHash = 0;
+    vector<unsigned char> ventana; // Últimos m bytes del flujo (circular)
+    uint64_t procesados = 0;    // Bytes del flujo ya procesados
+    size_t slot = 0;            // Posición del byte más antiguo de la ventana (procesados % m, sin dividir)
+};
 
 #endif // ROBIN_KARP_HPP
\ No newline at end of file
@@ -0,0 +1,30 @@
+/* Implementacion del filtro "primer y ultimo byte" con instrucciones SIMD.
+   Las busquedas son plantillas sobre el sink de resultados y estan en simd.hpp;
+   aqui solo queda la deteccion del procesador y la version que devuelve un vector.
+*/
+
+#include <cstdint>
+#include <string_view>
+#include <vector>
+#include "simd.hpp"
+
+using namespace std;
+
+namespace simd {
+    // Se consulta una sola vez si el procesador soporta AVX2
+    bool tieneAVX2() {
+#ifdef SIMD_X86
+        static const bool soporta = __builtin_cpu_supports("avx2");
+        return soporta;
+#else
+        return false;
+#endif
+    }
+}
+
+vector<uint64_t> simdSearch(string_view text, string_view pattern) {
+    vector<uint64_t> result;
+    SinkPosiciones sink{&result};
+    simdSearch(text, pattern, sink);
+    return result;
+}
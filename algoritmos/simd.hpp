@@ -0,0 +1,146 @@
+#ifndef SIMD_HPP
+#define SIMD_HPP
+
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "plegado.hpp"
+#include "resultados.hpp"
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define SIMD_X86 1
+#endif
+
+/* Busqueda exacta vectorizada: compara el primer y el ultimo byte del patron en 32 (AVX2) o
+   16 (SSE2) posiciones del texto a la vez y solo verifica completas las posiciones candidatas.
+   En procesadores sin AVX2 se elige en tiempo de ejecucion la version SSE2 o la escalar.
+
+   Para cada bloque de posiciones i se cargan text[i..i+W) y text[i+m-1..i+m-1+W), se comparan contra
+   el primer y el ultimo byte del patron repetidos W veces, y el AND de ambas comparaciones deja una
+   mascara de bits con las posiciones candidatas. En texto real casi ninguna posicion sobrevive al
+   filtro, por lo que la verificacion byte a byte (memcmp del centro del patron) es poco frecuente.
+*/
+
+namespace simd {
+
+    bool tieneAVX2();
+
+    // Verifica las posiciones candidatas marcadas en 'mascara' a partir de la posicion 'base'.
+    // Devuelve false si el sink pidio detener la busqueda.
+    template <class Plegar, class Sink>
+    inline bool verificar(unsigned mascara, size_t base, const char *text, std::string_view pattern, Sink &sink, Plegar plegar) {
+        size_t m = pattern.size();
+        while (mascara != 0) {
+            size_t i = base + __builtin_ctz(mascara);
+            // El primer y el ultimo byte ya coinciden, se compara solo el centro
+            anotar(sink, &Estadisticas::comparaciones, m);
+            if (m <= 2 || iguales(text + i + 1, pattern.data() + 1, m - 2, plegar)) {
+                if (!sink.reportar(i)) return false;
+            }
+            mascara &= mascara - 1; // Quitar el bit menos significativo
+        }
+        return true;
+    }
+
+    // Version escalar, usada para el final del texto y en procesadores sin SIMD
+    template <class Plegar, class Sink>
+    void escalar(std::string_view text, std::string_view pattern, size_t desde, Sink &sink, Plegar plegar) {
+        size_t n = text.size(), m = pattern.size();
+        const unsigned char primero = pattern[0], ultimo = pattern[m - 1];
+        for (size_t i = desde; i + m <= n; i++) {
+            anotar(sink, &Estadisticas::comparaciones);
+            if (plegar(text[i]) == primero && plegar(text[i + m - 1]) == ultimo &&
+                iguales(text.data() + i + 1, pattern.data() + 1, m > 2 ? m - 2 : 0, plegar)) {
+                if (!sink.reportar(i)) return;
+            }
+        }
+    }
+
+#ifdef SIMD_X86
+    // Sin distinguir mayusculas, un byte del bloque es candidato si es igual al byte del patron o a su otro caso
+    template <class Plegar>
+    __attribute__((target("sse2")))
+    inline __m128i iguales128(__m128i bloque, unsigned char c) {
+        __m128i iguales = _mm_cmpeq_epi8(bloque, _mm_set1_epi8(c));
+        if constexpr (Plegar::activo) iguales = _mm_or_si128(iguales, _mm_cmpeq_epi8(bloque, _mm_set1_epi8(Plegar::otro(c))));
+        return iguales;
+    }
+
+    template <class Plegar>
+    __attribute__((target("avx2")))
+    inline __m256i iguales256(__m256i bloque, unsigned char c) {
+        __m256i iguales = _mm256_cmpeq_epi8(bloque, _mm256_set1_epi8(c));
+        if constexpr (Plegar::activo) iguales = _mm256_or_si256(iguales, _mm256_cmpeq_epi8(bloque, _mm256_set1_epi8(Plegar::otro(c))));
+        return iguales;
+    }
+
+    // SSE2 es parte de la base de x86-64, siempre esta disponible.
+    // Devuelve la primera posicion que no alcanzo a revisar (o SIZE_MAX si el sink pidio detenerse).
+    template <class Plegar, class Sink>
+    __attribute__((target("sse2")))
+    size_t sse2(std::string_view text, std::string_view pattern, Sink &sink, Plegar plegar) {
+        size_t n = text.size(), m = pattern.size();
+        const unsigned char primero = pattern[0], ultimo = pattern[m - 1];
+        size_t i = 0;
+        for (; i + m - 1 + 16 <= n; i += 16) {
+            __m128i bloque_inicio = _mm_loadu_si128(reinterpret_cast<const __m128i *>(text.data() + i));
+            __m128i bloque_fin = _mm_loadu_si128(reinterpret_cast<const __m128i *>(text.data() + i + m - 1));
+            __m128i iguales = _mm_and_si128(iguales128<Plegar>(bloque_inicio, primero), iguales128<Plegar>(bloque_fin, ultimo));
+            if (!verificar(_mm_movemask_epi8(iguales), i, text.data(), pattern, sink, plegar)) return SIZE_MAX;
+        }
+        return i;
+    }
+
+    template <class Plegar, class Sink>
+    __attribute__((target("avx2")))
+    size_t avx2(std::string_view text, std::string_view pattern, Sink &sink, Plegar plegar) {
+        size_t n = text.size(), m = pattern.size();
+        const unsigned char primero = pattern[0], ultimo = pattern[m - 1];
+        size_t i = 0;
+        for (; i + m - 1 + 32 <= n; i += 32) {
+            __m256i bloque_inicio = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(text.data() + i));
+            __m256i bloque_fin = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(text.data() + i + m - 1));
+            __m256i iguales = _mm256_and_si256(iguales256<Plegar>(bloque_inicio, primero), iguales256<Plegar>(bloque_fin, ultimo));
+            if (!verificar(static_cast<unsigned>(_mm256_movemask_epi8(iguales)), i, text.data(), pattern, sink, plegar)) return SIZE_MAX;
+        }
+        return i;
+    }
+#endif
+}
+
+// Cada coincidencia se entrega al sink (ver resultados.hpp).
+// Con SinMayusculas el patron debe venir ya plegado (ver plegado.hpp).
+template <class Sink, class Plegar = Exacto>
+void simdSearch(std::string_view text, std::string_view pattern, Sink &sink, Plegar plegar = Plegar()) {
+    size_t n = text.size(), m = pattern.size();
+    if (m == 0 || n < m) return;
+
+    size_t desde = 0;
+#ifdef SIMD_X86
+    desde = simd::tieneAVX2() ? simd::avx2(text, pattern, sink, plegar) : simd::sse2(text, pattern, sink, plegar);
+    if (desde == SIZE_MAX) return;
+#endif
+    simd::escalar(text, pattern, desde, sink, plegar);
+}
+
+// El filtro no tiene tablas: el patron compilado solo guarda el patron (plegado con SinMayusculas)
+template <class Plegar = Exacto>
+class SimdCompilado {
+public:
+    explicit SimdCompilado(std::string_view patron) : pattern(Plegar::activo ? plegar(patron) : std::string(patron)) {}
+
+    template <class Sink>
+    void buscar(std::string_view text, Sink &sink) const { simdSearch(text, pattern, sink, Plegar()); }
+
+    size_t largo() const { return pattern.size(); }
+
+private:
+    std::string pattern;
+};
+
+std::vector<uint64_t> simdSearch(std::string_view text, std::string_view pattern);
+
+#endif // SIMD_HPP
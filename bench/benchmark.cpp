@@ -0,0 +1,166 @@
+/* Benchmark de los algoritmos de búsqueda.
+   Para cada algoritmo, tamaño de corpus y grupo de largo de patrón se compilan los patrones del grupo una vez
+   y se hacen repeticiones de calentamiento y luego varias repeticiones medidas, cada una con la búsqueda de
+   todos los patrones del grupo (una muestra por repetición). Se informa el tiempo mínimo, la mediana y el
+   percentil 99 de una repetición, el rendimiento (MB/s) y las coincidencias por segundo a partir de la
+   mediana, y los resultados se pueden guardar en CSV y/o JSON para comparar compilaciones.
+
+   Uso: ./benchmark.exe <CarpetaOArchivo> <ArchivoPatrones> [-r repeticiones] [-w calentamiento]
+                        [-t tamaño1,tamaño2,...] [--csv archivo] [--json archivo]
+*/
+
+#include <bits/stdc++.h>
+#include <filesystem>
+#include "utils.hpp"
+#include "planificador.hpp"
+#include "algoritmos/patron_compilado.hpp"
+#include "algoritmos/aho_corasick.hpp"
+
+using namespace std;
+namespace fs = std::filesystem;
+using Reloj = chrono::steady_clock;
+
+struct Resultado {
+    string algoritmo;
+    size_t tamano_corpus;
+    string grupo;
+    size_t patrones;
+    vector<long long> tiempos; // ns de cada repetición medida (todos los patrones del grupo)
+    uint64_t coincidencias = 0; // Coincidencias por repetición
+};
+
+static long long percentil(vector<long long> v, double p) {
+    sort(v.begin(), v.end());
+    size_t i = min(v.size() - 1, static_cast<size_t>(ceil(p * v.size())) - (p > 0 ? 1 : 0));
+    return v[i];
+}
+
+// Mide 'buscar' (una repetición sobre todos los patrones del grupo) con calentamiento y repeticiones
+static void medir(const function<size_t()> &buscar, int calentamiento, int repeticiones, Resultado *r) {
+    size_t encontrados = 0;
+    for (int i = 0; i < calentamiento; i++) encontrados = buscar();
+    for (int i = 0; i < repeticiones; i++) {
+        auto inicio = Reloj::now();
+        encontrados = buscar();
+        auto fin = Reloj::now();
+        r->tiempos.push_back(chrono::duration_cast<chrono::nanoseconds>(fin - inicio).count());
+    }
+    r->coincidencias = encontrados;
+}
+
+int main(int argc, char *argv[]) {
+
+    if (argc < 3) {
+        cerr << "Uso: " << argv[0] << " <CarpetaOArchivo> <ArchivoPatrones> [-r repeticiones] [-w calentamiento]"
+             << " [-t tamaño1,tamaño2,...] [--csv archivo] [--json archivo]" << endl;
+        return 1;
+    }
+
+    string ruta = argv[1];
+    string archivo_patrones = argv[2];
+    int repeticiones = 10, calentamiento = 2;
+    vector<size_t> tamanos;
+    string salida_csv, salida_json;
+    for (int i = 3; i < argc; i++) {
+        string arg = argv[i];
+        if (arg == "-r" && i + 1 < argc) repeticiones = max(1, stoi(argv[++i]));
+        else if (arg == "-w" && i + 1 < argc) calentamiento = max(0, stoi(argv[++i]));
+        else if (arg == "--csv" && i + 1 < argc) salida_csv = argv[++i];
+        else if (arg == "--json" && i + 1 < argc) salida_json = argv[++i];
+        else if (arg == "-t" && i + 1 < argc) {
+            // Tamaños de corpus a medir (prefijos del corpus), en bytes
+            stringstream lista(argv[++i]);
+            string t;
+            while (getline(lista, t, ',')) tamanos.push_back(stoull(t));
+        } else {
+            cerr << "Opción no reconocida: " << arg << endl;
+            return 1;
+        }
+    }
+
+    Corpus corpus;
+    vector<uint64_t> pos_final_archivos;
+    bool leido = fs::is_directory(ruta) ? corpus.cargarCarpeta(ruta, &pos_final_archivos) : corpus.cargarArchivo(ruta);
+    vector<string> patrones;
+    if (!leido || !leerPatrones(archivo_patrones, &patrones) || patrones.empty()) {
+        cerr << "Error al leer el corpus o los patrones." << endl;
+        return 1;
+    }
+    string_view texto = corpus.texto();
+    if (tamanos.empty()) tamanos.push_back(texto.size());
+
+    // Agrupar los patrones por largo
+    map<size_t, vector<string>> grupos;
+    for (const auto &p : patrones) grupos[grupo_largo(p.size())].push_back(p);
+
+    vector<Resultado> resultados;
+    for (size_t tamano : tamanos) {
+        string_view trozo = texto.substr(0, min(tamano, texto.size()));
+        for (const auto &[g, lista] : grupos) {
+            const string &grupo = NOMBRES_GRUPOS[g];
+            for (const string &nombre : MOTORES) {
+                // Los patrones se compilan fuera de la medición, que solo cuenta las coincidencias con buscar
+                vector<PatronCompilado> compilados;
+                for (const auto &p : lista) compilados.emplace_back(nombre, p);
+                Resultado r{nombre, trozo.size(), grupo, lista.size(), {}, 0};
+                medir([&] {
+                    SinkConteo sink;
+                    for (const PatronCompilado &patron : compilados) patron.buscar(trozo, sink);
+                    return sink.cantidad;
+                }, calentamiento, repeticiones, &r);
+                resultados.push_back(move(r));
+            }
+            // Aho-Corasick busca todos los patrones del grupo en una sola pasada
+            Resultado r{"Aho-Corasick", trozo.size(), grupo, lista.size(), {}, 0};
+            medir([&] {
+                size_t total = 0;
+                for (const auto &pos : ahoCorasick(trozo, lista)) total += pos.size();
+                return total;
+            }, calentamiento, repeticiones, &r);
+            resultados.push_back(move(r));
+        }
+    }
+
+    // Resumen por pantalla y archivos de salida
+    ofstream csv, json;
+    if (!salida_csv.empty()) {
+        csv.open(salida_csv);
+        csv << "algoritmo,tamano_corpus,largo_patron,patrones,busquedas,min_ns,mediana_ns,p99_ns,mb_s,coincidencias_s\n";
+    }
+    if (!salida_json.empty()) {
+        json.open(salida_json);
+        json << "[\n";
+    }
+
+    cout << "\nAlgoritmo, Tamaño corpus, Largo patrón, Patrones, Min (ns), Mediana (ns), P99 (ns), MB/s, Coincidencias/s" << endl;
+    for (size_t i = 0; i < resultados.size(); i++) {
+        const Resultado &r = resultados[i];
+        long long minimo = *min_element(r.tiempos.begin(), r.tiempos.end());
+        long long mediana = percentil(r.tiempos, 0.5);
+        long long p99 = percentil(r.tiempos, 0.99);
+
+        // Una repetición recorre el corpus una vez por patrón (Aho-Corasick una sola vez en total)
+        size_t pasadas = r.algoritmo == "Aho-Corasick" ? 1 : r.patrones;
+        double segundos_repeticion = mediana * 1e-9;
+        double mbs = segundos_repeticion > 0 ? (r.tamano_corpus * pasadas / 1e6) / segundos_repeticion : 0;
+        double coincidencias_s = segundos_repeticion > 0 ? r.coincidencias / segundos_repeticion : 0;
+
+        cout << r.algoritmo << ",  " << r.tamano_corpus << ",  " << r.grupo << ",  " << r.patrones << ",  "
+             << minimo << ",  " << mediana << ",  " << p99 << ",  " << mbs << ",  " << coincidencias_s << endl;
+
+        if (csv.is_open()) {
+            csv << r.algoritmo << "," << r.tamano_corpus << "," << r.grupo << "," << r.patrones << "," << r.tiempos.size() << ","
+                << minimo << "," << mediana << "," << p99 << "," << mbs << "," << coincidencias_s << "\n";
+        }
+        if (json.is_open()) {
+            json << "  {\"algoritmo\": \"" << r.algoritmo << "\", \"tamano_corpus\": " << r.tamano_corpus
+                 << ", \"largo_patron\": \"" << r.grupo << "\", \"patrones\": " << r.patrones
+                 << ", \"busquedas\": " << r.tiempos.size() << ", \"min_ns\": " << minimo
+                 << ", \"mediana_ns\": " << mediana << ", \"p99_ns\": " << p99
+                 << ", \"mb_s\": " << mbs << ", \"coincidencias_s\": " << coincidencias_s << "}"
+                 << (i + 1 < resultados.size() ? "," : "") << "\n";
+        }
+    }
+    if (json.is_open()) json << "]\n";
+    return 0;
+}
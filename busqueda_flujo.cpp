@@ -0,0 +1,59 @@
+#include <fstream>
+#include <iostream>
+#include <vector>
+#include "busqueda_flujo.hpp"
+#include "algoritmos/boyer_moore.hpp"
+#include "algoritmos/KMP.hpp"
+#include "algoritmos/robin_karp.hpp"
+
+using namespace std;
+
+// Tamaño de cada bloque leído del archivo. La memoria usada es O(TAMANO_BLOQUE + m).
+constexpr size_t TAMANO_BLOQUE = 1 << 20;
+
+// Lee cada archivo bloque por bloque y se los entrega al buscador, que conserva su estado entre bloques
+template <class BuscadorFlujo>
+static bool recorrer(const vector<string> &archivos, BuscadorFlujo &buscador, vector<uint64_t> *conteos) {
+
+    conteos->assign(archivos.size(), 0);
+    vector<char> bloque(TAMANO_BLOQUE); // Un solo buffer para todos los archivos
+
+    for (size_t a = 0; a < archivos.size(); a++) {
+        ifstream file(archivos[a], ios::binary);
+        if (!file.is_open()) {
+            cerr << "Error al abrir el archivo: " << archivos[a] << endl;
+            return false;
+        }
+
+        uint64_t &cantidad = (*conteos)[a];
+        auto contar = [&cantidad](uint64_t) { cantidad++; };
+
+        buscador.reiniciar();
+        while (file) {
+            file.read(bloque.data(), bloque.size());
+            streamsize leidos = file.gcount();
+            if (leidos <= 0) break;
+            buscador.alimentar(string_view(bloque.data(), leidos), contar);
+        }
+        if (file.bad()) return false;
+    }
+    return true;
+}
+
+bool buscarFlujo(const vector<string> &archivos, const string &algoritmo, string_view patron, vector<uint64_t> *conteos,
+                 bool ignorarMayusculas) {
+
+    if (algoritmo == "Boyer-Moore") {
+        BoyerMooreFlujo buscador(patron, ignorarMayusculas);
+        return recorrer(archivos, buscador, conteos);
+    } else if (algoritmo == "KMP") {
+        KMPFlujo buscador(patron, ignorarMayusculas);
+        return recorrer(archivos, buscador, conteos);
+    } else if (algoritmo == "Robin-Karp") {
+        RobinKarpFlujo buscador(patron, ignorarMayusculas);
+        return recorrer(archivos, buscador, conteos);
+    }
+
+    cerr << "Algoritmo no disponible en modo flujo. Ingresar alguno de los siguientes: Boyer-Moore, KMP, Robin-Karp" << endl;
+    return false;
+}
@@ -0,0 +1,18 @@
+#ifndef BUSQUEDA_FLUJO_HPP
+#define BUSQUEDA_FLUJO_HPP
+
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <vector>
+using namespace std;
+
+// Busca el patrón en cada archivo leyéndolo en bloques de tamaño fijo, sin cargarlo completo en memoria.
+// El patrón se preprocesa una sola vez para todos los archivos. conteos[a] recibe las ocurrencias del archivo a.
+// Devuelve false si el algoritmo no se reconoce o algún archivo no se puede leer.
+// Con ignorarMayusculas (-i) cada bloque se compara a través de la tabla de plegado.
+bool buscarFlujo(const vector<string> &archivos, const string &algoritmo, string_view patron, vector<uint64_t> *conteos,
+                 bool ignorarMayusculas = false);
+
+#endif
@@ -0,0 +1,106 @@
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <thread>
+#include "busqueda_paralela.hpp"
+
+using namespace std;
+
+// Tamaño mínimo de cada trozo, para que el costo de crear tareas no supere al de buscar
+constexpr size_t TROZO_MINIMO = 1 << 16;
+// Trozos por hilo: más trozos que hilos reparten mejor la carga cuando algunos trozos son más lentos
+constexpr size_t TROZOS_POR_HILO = 4;
+
+// Reparte los trozos entre los hilos. 'trabajo(t, trozo, inicio)' busca el trozo t, que empieza en 'inicio'
+// y ya incluye los m - 1 bytes extra para encontrar los patrones que cruzan el borde.
+// Devuelve la cantidad de trozos, o 0 si no vale la pena dividir el texto.
+template <class Trabajo>
+static size_t porTrozos(string_view texto, size_t m, int hilos, size_t *cant, Trabajo trabajo) {
+
+    size_t n = texto.size();
+    if (hilos <= 1 || m == 0 || n < m) return 0;
+
+    // Cada trozo es dueño de las posiciones de inicio [inicio, inicio + largo_trozo)
+    size_t inicios = n - m + 1;
+    size_t cant_trozos = max<size_t>(1, min(hilos * TROZOS_POR_HILO, inicios / TROZO_MINIMO));
+    size_t largo_trozo = (inicios + cant_trozos - 1) / cant_trozos;
+    cant_trozos = (inicios + largo_trozo - 1) / largo_trozo;
+    *cant = cant_trozos;
+
+    atomic<size_t> siguiente(0);
+
+    // Cada hilo toma el siguiente trozo libre hasta que no queden
+    auto trabajador = [&]() {
+        for (size_t t = siguiente++; t < cant_trozos; t = siguiente++) {
+            size_t inicio = t * largo_trozo;
+            size_t fin = min(inicio + largo_trozo, inicios);
+            trabajo(t, texto.substr(inicio, fin - inicio + m - 1), inicio);
+        }
+    };
+
+    vector<thread> pool;
+    int cant_hilos = min<size_t>(hilos, cant_trozos);
+    for (int i = 0; i < cant_hilos; i++) pool.emplace_back(trabajador);
+    for (auto &h : pool) h.join();
+    return cant_trozos;
+}
+
+void buscarParalelo(string_view texto, size_t largo_patron, int hilos, const Buscador &buscar, vector<uint64_t> *posiciones,
+                    vector<vector<uint64_t>> *trozos) {
+
+    // Nunca hay más de hilos * TROZOS_POR_HILO trozos, así que los buffers se preparan antes de lanzar los hilos
+    vector<vector<uint64_t>> &resultados = *trozos;
+    if (resultados.size() < max<size_t>(1, hilos) * TROZOS_POR_HILO) resultados.resize(max<size_t>(1, hilos) * TROZOS_POR_HILO);
+    for (vector<uint64_t> &resultado : resultados) resultado.clear();
+    size_t cant_trozos = 0;
+    bool dividido = porTrozos(texto, largo_patron, hilos, &cant_trozos,
+        [&](size_t t, string_view trozo, size_t inicio) {
+            buscar.posiciones(trozo, &resultados[t]);
+            for (uint64_t &pos : resultados[t]) pos += inicio;
+        });
+
+    posiciones->clear();
+    if (!dividido) {
+        buscar.posiciones(texto, posiciones);
+        return;
+    }
+
+    // Unir los resultados en orden
+    size_t total = 0;
+    for (size_t t = 0; t < cant_trozos; t++) total += resultados[t].size();
+    posiciones->reserve(total);
+    for (size_t t = 0; t < cant_trozos; t++) posiciones->insert(posiciones->end(), resultados[t].begin(), resultados[t].end());
+}
+
+uint64_t contarParalelo(string_view texto, size_t largo_patron, int hilos, const Buscador &buscar) {
+
+    atomic<uint64_t> total(0);
+    size_t cant_trozos = 0;
+    bool dividido = porTrozos(texto, largo_patron, hilos, &cant_trozos,
+        [&](size_t, string_view trozo, size_t) { total += buscar.contar(trozo); });
+
+    return dividido ? total.load() : buscar.contar(texto);
+}
+
+void escalamiento(string_view texto, size_t largo_patron, int max_hilos, const Buscador &buscar) {
+
+    // Los vectores se reutilizan entre las cantidades de hilos
+    vector<uint64_t> referencia, posiciones;
+    vector<vector<uint64_t>> trozos;
+    cout << "\nHilos, Tiempo (ns), MB/s, Coincidencias" << endl;
+    for (int hilos = 1; ; hilos = min(hilos * 2, max_hilos)) {
+        auto inicio = chrono::high_resolution_clock::now();
+        buscarParalelo(texto, largo_patron, hilos, buscar, &posiciones, &trozos);
+        auto fin = chrono::high_resolution_clock::now();
+
+        long long ns = chrono::duration_cast<chrono::nanoseconds>(fin - inicio).count();
+        double mbs = ns > 0 ? (texto.size() / 1e6) / (ns / 1e9) : 0;
+        cout << hilos << ",  " << ns << ",  " << mbs << ",  " << posiciones.size() << endl;
+
+        // Todas las cantidades de hilos deben dar exactamente el mismo resultado
+        if (hilos == 1) referencia.swap(posiciones);
+        else if (posiciones != referencia) cerr << "ADVERTENCIA: resultado distinto con " << hilos << " hilos." << endl;
+
+        if (hilos >= max_hilos) break;
+    }
+}
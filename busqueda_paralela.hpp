@@ -0,0 +1,68 @@
+#ifndef BUSQUEDA_PARALELA_HPP
+#define BUSQUEDA_PARALELA_HPP
+
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "algoritmos/resultados.hpp"
+using namespace std;
+
+// Algoritmo ya preparado para un patrón, con una función por cada modo de resultado.
+// Las tablas del patrón se calculan una sola vez y se comparten entre todos los trozos.
+struct Buscador {
+    function<void(string_view, vector<uint64_t> *)> posiciones;           // Todas las posiciones
+    function<uint64_t(string_view)> contar;                               // Solo la cantidad
+    function<bool(string_view, uint64_t *)> primera;                      // Primera posición (si existe)
+    function<void(string_view, const function<bool(uint64_t)> &)> cada;   // Una función por coincidencia
+    function<Estadisticas(string_view)> estadisticas;                     // Contadores internos (--stats)
+};
+
+// Arma un Buscador a partir de una función (texto, sink) genérica. Cada modo instancia el algoritmo
+// con su sink concreto, así el sink queda insertado en el ciclo de búsqueda del algoritmo.
+template <class Motor>
+Buscador hacerBuscador(Motor motor) {
+    Buscador b;
+    b.posiciones = [motor](string_view texto, vector<uint64_t> *pos) {
+        SinkPosiciones sink{pos};
+        motor(texto, sink);
+    };
+    b.contar = [motor](string_view texto) {
+        SinkConteo sink;
+        motor(texto, sink);
+        return sink.cantidad;
+    };
+    b.primera = [motor](string_view texto, uint64_t *pos) {
+        SinkPrimera sink;
+        motor(texto, sink);
+        *pos = sink.posicion;
+        return sink.encontrada;
+    };
+    b.cada = [motor](string_view texto, const function<bool(uint64_t)> &funcion) {
+        auto sink = sinkFuncion(funcion);
+        motor(texto, sink);
+    };
+    // Única instancia con contadores; los demás modos se compilan sin ellos
+    b.estadisticas = [motor](string_view texto) {
+        SinkEstadisticas sink;
+        motor(texto, sink);
+        return sink.estadisticas;
+    };
+    return b;
+}
+
+// Divide el texto en trozos que se traslapan en largo_patron - 1 bytes y los busca en 'hilos' hilos.
+// Las posiciones reemplazan el contenido de 'posiciones', ordenadas y exactamente las mismas que en la búsqueda
+// secuencial. 'trozos' guarda las posiciones de cada trozo antes de unirlas: el que llama lo conserva entre
+// búsquedas (una por patrón con -p) para no volver a hacer crecer sus vectores, y lo libera al terminar.
+void buscarParalelo(string_view texto, size_t largo_patron, int hilos, const Buscador &buscar, vector<uint64_t> *posiciones,
+                    vector<vector<uint64_t>> *trozos);
+
+// Igual que buscarParalelo, pero solo cuenta las coincidencias (sin guardar posiciones)
+uint64_t contarParalelo(string_view texto, size_t largo_patron, int hilos, const Buscador &buscar);
+
+// Mide el rendimiento de la búsqueda paralela con 1, 2, 4, ... hilos hasta max_hilos e imprime un CSV
+void escalamiento(string_view texto, size_t largo_patron, int max_hilos, const Buscador &buscar);
+
+#endif
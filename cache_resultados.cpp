@@ -0,0 +1,291 @@
+#include <algorithm>
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <unordered_map>
+#include "cache_resultados.hpp"
+#include "utils.hpp"
+
+using namespace std;
+namespace fs = std::filesystem;
+
+// Identifica el formato de los archivos de la caché
+static const char MAGIA[8] = {'P', 'A', 'T', 'C', 'A', 'C', 'H', '2'};
+
+// Cota de la carpeta de la caché: al superarla se borran las claves usadas hace más tiempo, y las claves que no
+// se usan hace más de DIAS_SIN_USO días se borran siempre
+static const uint64_t LIMITE_CACHE = 256ULL << 20;
+static const int DIAS_SIN_USO = 30;
+
+struct EntradaCache {
+    uint64_t tam = 0;
+    int64_t modificacion = 0;      // Fecha de modificación en ticks del reloj del sistema de archivos
+    vector<uint64_t> posiciones;   // Posiciones dentro del archivo (desde 0)
+};
+
+// Resultados de un par (algoritmo, patrón), por ruta del archivo
+using EntradasClave = unordered_map<string, EntradaCache>;
+
+// Cada par (algoritmo, patrón) se guarda en su propio archivo, nombrado con el hash FNV-1a de 64 bits del par.
+// El archivo repite el algoritmo y el patrón, así una colisión de hash se detecta al leerlo.
+static string nombre_clave(const string &algoritmo, const string &patron) {
+    uint64_t h = 14695981039346656037ULL;
+    for (const string &parte : {algoritmo, string(1, '\0'), patron}) {
+        for (unsigned char c : parte) h = (h ^ c) * 1099511628211ULL;
+    }
+    static const char hex[] = "0123456789abcdef";
+    string nombre(16, '0');
+    for (int i = 15; i >= 0; i--, h >>= 4) nombre[i] = hex[h & 15];
+    return nombre + ".bin";
+}
+
+static void escribir_u64(ofstream &out, uint64_t valor) {
+    out.write(reinterpret_cast<const char *>(&valor), sizeof(valor));
+}
+
+static bool leer_u64(ifstream &in, uint64_t *valor) {
+    return bool(in.read(reinterpret_cast<char *>(valor), sizeof(*valor)));
+}
+
+// Lee 'largo' bytes en 'texto', sin reservar más de lo que queda en el archivo
+static bool leer_texto(ifstream &in, uint64_t largo, uint64_t restantes, string *texto) {
+    if (largo > restantes) return false;
+    texto->resize(largo);
+    return bool(in.read(&(*texto)[0], largo));
+}
+
+// Carga los resultados guardados de un par. Si no existen, son de otro par o están dañados, se empieza sin resultados.
+static EntradasClave leer_clave(const fs::path &ruta, const string &algoritmo, const string &patron) {
+
+    EntradasClave entradas;
+    ifstream in(ruta, ios::binary);
+    if (!in.is_open()) return entradas;
+    error_code error;
+    uint64_t tam_archivo = fs::file_size(ruta, error);
+    if (error) return entradas;
+    auto restantes = [&]() { return tam_archivo - uint64_t(in.tellg()); };
+
+    char magia[sizeof(MAGIA)];
+    uint64_t largo;
+    string guardado_algoritmo, guardado_patron;
+    if (!in.read(magia, sizeof(magia)) || !equal(magia, magia + sizeof(magia), MAGIA) || !leer_u64(in, &largo) ||
+        !leer_texto(in, largo, restantes(), &guardado_algoritmo) || !leer_u64(in, &largo) ||
+        !leer_texto(in, largo, restantes(), &guardado_patron)) {
+        cerr << "Caché con formato desconocido, se ignora: " << ruta.string() << endl;
+        return entradas;
+    }
+    if (guardado_algoritmo != algoritmo || guardado_patron != patron) return entradas; // Colisión de hash
+
+    uint64_t modificacion, cantidad;
+    while (leer_u64(in, &largo)) {
+        string archivo;
+        EntradaCache entrada;
+        if (!leer_texto(in, largo, restantes(), &archivo) || !leer_u64(in, &entrada.tam) || !leer_u64(in, &modificacion) ||
+            !leer_u64(in, &cantidad) || cantidad > restantes() / sizeof(uint64_t)) {
+            cerr << "Caché incompleta, se ignora el resto: " << ruta.string() << endl;
+            break;
+        }
+        entrada.modificacion = int64_t(modificacion);
+        entrada.posiciones.resize(cantidad);
+        if (!in.read(reinterpret_cast<char *>(entrada.posiciones.data()), cantidad * sizeof(uint64_t))) {
+            cerr << "Caché incompleta, se ignora el resto: " << ruta.string() << endl;
+            break;
+        }
+        entradas[move(archivo)] = move(entrada);
+    }
+    return entradas;
+}
+
+// Reescribe los resultados de un par en un archivo temporal y lo renombra, para no dejarlos a medias si el programa se corta
+static bool escribir_clave(const fs::path &ruta, const string &algoritmo, const string &patron, const EntradasClave &entradas) {
+
+    string temporal = ruta.string() + ".tmp";
+    ofstream out(temporal, ios::binary);
+    if (!out.is_open()) {
+        cerr << "Error al escribir la caché: " << temporal << endl;
+        return false;
+    }
+
+    out.write(MAGIA, sizeof(MAGIA));
+    escribir_u64(out, algoritmo.size());
+    out.write(algoritmo.data(), algoritmo.size());
+    escribir_u64(out, patron.size());
+    out.write(patron.data(), patron.size());
+    for (const auto &[archivo, entrada] : entradas) {
+        escribir_u64(out, archivo.size());
+        out.write(archivo.data(), archivo.size());
+        escribir_u64(out, entrada.tam);
+        escribir_u64(out, uint64_t(entrada.modificacion));
+        escribir_u64(out, entrada.posiciones.size());
+        out.write(reinterpret_cast<const char *>(entrada.posiciones.data()), entrada.posiciones.size() * sizeof(uint64_t));
+    }
+    out.close();
+    if (!out) {
+        cerr << "Error al escribir la caché: " << temporal << endl;
+        return false;
+    }
+
+    error_code error;
+    fs::rename(temporal, ruta, error);
+    if (error) {
+        cerr << "Error al reemplazar la caché: " << ruta.string() << endl;
+        return false;
+    }
+    return true;
+}
+
+// Borra las claves sin uso hace más de DIAS_SIN_USO días y, si la caché sigue pasando LIMITE_CACHE bytes,
+// las usadas hace más tiempo (cada uso actualiza la fecha de modificación de la clave)
+static void recortar_cache(const fs::path &carpeta_cache) {
+
+    struct Clave {
+        fs::file_time_type uso;
+        uint64_t tam;
+        fs::path ruta;
+    };
+    vector<Clave> claves;
+    uint64_t total = 0;
+    auto limite_uso = fs::file_time_type::clock::now() - chrono::hours(24 * DIAS_SIN_USO);
+    error_code error;
+    for (fs::directory_iterator it(carpeta_cache, error), fin; !error && it != fin; it.increment(error)) {
+        error_code error_clave;
+        uint64_t tam = it->file_size(error_clave);
+        fs::file_time_type uso = it->last_write_time(error_clave);
+        if (error_clave) continue;
+        if (uso < limite_uso) {
+            fs::remove(it->path(), error_clave);
+            continue;
+        }
+        claves.push_back({uso, tam, it->path()});
+        total += tam;
+    }
+    if (total <= LIMITE_CACHE) return;
+
+    sort(claves.begin(), claves.end(), [](const Clave &a, const Clave &b) { return a.uso < b.uso; });
+    for (const Clave &clave : claves) {
+        if (total <= LIMITE_CACHE) break;
+        if (fs::remove(clave.ruta, error)) total -= clave.tam;
+    }
+}
+
+bool buscar_con_cache(const string &carpeta, int cantidadArchivos, const string &algoritmo, const vector<string> &patrones,
+                      const BuscadorCorpus &buscar, vector<vector<uint64_t>> *posiciones,
+                      vector<uint64_t> *pos_final_archivos, vector<string> *nombres, EstadisticasCache *estadisticas) {
+
+    if (!fs::is_directory(carpeta)) {
+        cerr << "La ruta especificada no es una carpeta: " << carpeta << endl;
+        return false;
+    }
+
+    // La caché es una carpeta con un archivo por par (algoritmo, patrón); solo se leen los de los patrones buscados.
+    // Un <carpeta>.cache del formato anterior (un solo archivo con todos los pares) se reemplaza.
+    fs::path carpeta_cache = ruta_base(carpeta) + ".cache";
+    error_code error;
+    if (fs::is_regular_file(carpeta_cache, error)) fs::remove(carpeta_cache, error);
+    fs::create_directories(carpeta_cache, error);
+    if (error) {
+        cerr << "Error al crear la carpeta de la caché: " << carpeta_cache.string() << endl;
+        return false;
+    }
+    vector<fs::path> rutas_clave(patrones.size());
+    vector<EntradasClave> cache(patrones.size());
+    vector<bool> cambiada(patrones.size(), false);
+    for (size_t p = 0; p < patrones.size(); p++) {
+        rutas_clave[p] = carpeta_cache / nombre_clave(algoritmo, patrones[p]);
+        cache[p] = leer_clave(rutas_clave[p], algoritmo, patrones[p]);
+    }
+
+    // Tamaño y fecha actuales de cada archivo, y qué archivos hay que volver a buscar
+    vector<string> archivos = listar_archivos(carpeta, cantidadArchivos);
+    size_t cant = archivos.size();
+    vector<uint64_t> tam(cant);
+    vector<int64_t> modificacion(cant);
+    vector<bool> leer(cant, false);
+    for (size_t a = 0; a < cant; a++) {
+        error_code error_tam, error_fecha;
+        tam[a] = fs::file_size(archivos[a], error_tam);
+        modificacion[a] = fs::last_write_time(archivos[a], error_fecha).time_since_epoch().count();
+        if (error_tam || error_fecha) {
+            cerr << "Error al abrir el archivo: " << archivos[a] << endl;
+            return false;
+        }
+        for (size_t p = 0; p < patrones.size(); p++) {
+            auto it = cache[p].find(archivos[a]);
+            bool vigente = it != cache[p].end() && it->second.tam == tam[a] && it->second.modificacion == modificacion[a];
+            if (vigente) estadisticas->aciertos++;
+            else estadisticas->fallos++, leer[a] = true;
+        }
+    }
+    // Leer y buscar solo los archivos nuevos o modificados
+    vector<string> pendientes;
+    vector<size_t> indice_pendiente; // Índice en 'archivos' de cada archivo pendiente
+    for (size_t a = 0; a < cant; a++) {
+        if (leer[a]) pendientes.push_back(archivos[a]), indice_pendiente.push_back(a);
+    }
+    estadisticas->archivos_leidos = pendientes.size();
+
+    if (!pendientes.empty()) {
+        Corpus corpus;
+        vector<uint64_t> finales;
+        if (!corpus.cargarArchivos(pendientes, &finales)) return false;
+        vector<vector<uint64_t>> encontradas = buscar(corpus.texto());
+
+        for (size_t p = 0; p < patrones.size(); p++) {
+
+            // Se parte con una entrada vacía por archivo pendiente para que los archivos sin coincidencias también queden en caché
+            vector<EntradaCache *> entradas(pendientes.size());
+            for (size_t i = 0; i < pendientes.size(); i++) {
+                size_t a = indice_pendiente[i];
+                EntradaCache &entrada = cache[p][archivos[a]];
+                entrada = EntradaCache{tam[a], modificacion[a], {}};
+                entradas[i] = &entrada;
+            }
+            cambiada[p] = true;
+
+            // Cada posición se guarda relativa al inicio de su archivo. Las coincidencias que cruzan
+            // al archivo siguiente no pertenecen a ninguno de los dos y se descartan (a diferencia de -f sin
+            // caché, que las cuenta en el archivo donde empiezan; ver cache_resultados.hpp).
+            for (uint64_t pos : encontradas[p]) {
+                size_t i = archivo_de_posicion(pos, finales);
+                if (i >= finales.size() || pos + patrones[p].size() - 1 > finales[i]) continue;
+                uint64_t inicio = i == 0 ? 1 : finales[i - 1] + 2;
+                if (pos < inicio) continue; // Coincidencia que empieza en el separador "$"
+                entradas[i]->posiciones.push_back(pos - inicio);
+            }
+        }
+    }
+
+    // Armar el resultado con el mismo formato que el corpus completo "$archivo1$archivo2..."
+    posiciones->assign(patrones.size(), {});
+    pos_final_archivos->clear();
+    nombres->clear();
+    uint64_t inicio = 1;
+    for (size_t a = 0; a < cant; a++) {
+        for (size_t p = 0; p < patrones.size(); p++) {
+            const EntradaCache &entrada = cache[p][archivos[a]];
+            for (uint64_t pos : entrada.posiciones) (*posiciones)[p].push_back(inicio + pos);
+        }
+        pos_final_archivos->push_back(inicio + tam[a] - 1);
+        nombres->push_back(fs::path(archivos[a]).filename().string());
+        inicio += tam[a] + 1;
+    }
+
+    // Se descartan las entradas de archivos que ya no existen. Solo se reescriben los pares que cambiaron; a los
+    // demás se les actualiza la fecha, que recortar_cache usa como fecha del último uso.
+    for (size_t p = 0; p < patrones.size(); p++) {
+        for (auto it = cache[p].begin(); it != cache[p].end();) {
+            if (fs::exists(it->first, error)) {
+                ++it;
+            } else {
+                it = cache[p].erase(it);
+                cambiada[p] = true;
+            }
+        }
+        if (cambiada[p]) escribir_clave(rutas_clave[p], algoritmo, patrones[p], cache[p]);
+        else fs::last_write_time(rutas_clave[p], fs::file_time_type::clock::now(), error);
+    }
+
+    recortar_cache(carpeta_cache);
+    return true;
+}
@@ -0,0 +1,37 @@
+#ifndef CACHE_RESULTADOS_HPP
+#define CACHE_RESULTADOS_HPP
+
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <vector>
+using namespace std;
+
+// Caché persistente de resultados por archivo para las búsquedas en carpetas (-f).
+// Se guarda junto a la carpeta en la carpeta <carpeta>.cache, con un archivo por par (algoritmo, patrón), así
+// cada búsqueda lee y reescribe solo los pares de sus patrones. Cada entrada de un par se identifica por la
+// ruta del archivo y guarda su tamaño y fecha de modificación junto con las posiciones de las coincidencias
+// dentro de él. Una entrada solo se usa si el tamaño y la fecha siguen iguales; si no, el archivo se vuelve
+// a leer y buscar. Los pares sin uso hace más de 30 días se borran, y si la caché pasa de 256 MiB, también
+// los usados hace más tiempo.
+// Como cada archivo se guarda por separado, las coincidencias que cruzan el separador "$" hacia el archivo
+// siguiente se descartan; -f sin caché las cuenta en el archivo donde empiezan.
+
+// Busca todos los patrones en un texto "$archivo1$archivo2..." y devuelve las posiciones de cada patrón
+using BuscadorCorpus = function<vector<vector<uint64_t>>(string_view texto)>;
+
+struct EstadisticasCache {
+    uint64_t aciertos = 0;          // Pares (patrón, archivo) respondidos desde la caché
+    uint64_t fallos = 0;            // Pares (patrón, archivo) que hubo que buscar
+    uint64_t archivos_leidos = 0;   // Archivos nuevos o modificados que se volvieron a leer
+};
+
+// Busca los patrones en los archivos de la carpeta usando la caché y la actualiza.
+// Devuelve las posiciones de cada patrón en el mismo formato que si se hubiera leído la carpeta completa
+// con Corpus::cargarCarpeta, junto con las posiciones finales y los nombres de los archivos.
+bool buscar_con_cache(const string &carpeta, int cantidadArchivos, const string &algoritmo, const vector<string> &patrones,
+                      const BuscadorCorpus &buscar, vector<vector<uint64_t>> *posiciones,
+                      vector<uint64_t> *pos_final_archivos, vector<string> *nombres, EstadisticasCache *estadisticas);
+
+#endif
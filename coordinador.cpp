@@ -0,0 +1,314 @@
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <csignal>
+#include <deque>
+#include <filesystem>
+#include <functional>
+#include <iostream>
+#include <queue>
+#include <poll.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include "coordinador.hpp"
+#include "utils.hpp"
+
+using namespace std;
+namespace fs = std::filesystem;
+
+// Protocolo por pipes (los dos extremos son procesos de la misma máquina, así que los enteros van tal cual):
+//   coordinador -> hijo: <cantidad de archivos del lote (uint32)><índice de cada archivo (uint32)>; 0 termina
+//   hijo -> coordinador: <ns de lectura y búsqueda (uint64)><ocurrencias (uint64) por patrón y por archivo del lote>
+
+// Tamaño de los lotes: al menos un archivo y a lo más LOTE_MAXIMO bytes. Los lotes acotan la memoria de cada
+// proceso y son la unidad que se mueve de un fragmento rezagado a un proceso libre.
+static const uint64_t LOTE_MINIMO = 1ull << 20;
+static const uint64_t LOTE_MAXIMO = 64ull << 20;
+
+static bool escribir_todo(int fd, const void *datos, size_t largo) {
+    const char *p = static_cast<const char *>(datos);
+    while (largo > 0) {
+        ssize_t n = write(fd, p, largo);
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) return false;
+        p += n;
+        largo -= n;
+    }
+    return true;
+}
+
+// Devuelve false si el otro extremo cerró el pipe antes de mandar 'largo' bytes
+static bool leer_todo(int fd, void *datos, size_t largo) {
+    char *p = static_cast<char *>(datos);
+    while (largo > 0) {
+        ssize_t n = read(fd, p, largo);
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) return false;
+        p += n;
+        largo -= n;
+    }
+    return true;
+}
+
+// Ciclo de un proceso hijo: recibe lotes hasta que el coordinador mande uno vacío
+static void trabajar(int entrada, int salida, const vector<string> &rutas, size_t cant_patrones,
+                     const BuscadorCorpus &buscar) {
+    Corpus corpus; // Su arena se reutiliza en todos los lotes que caben en ella
+    while (true) {
+        uint32_t cantidad;
+        if (!leer_todo(entrada, &cantidad, sizeof(cantidad)) || cantidad == 0) return;
+        vector<uint32_t> indices(cantidad);
+        if (!leer_todo(entrada, indices.data(), cantidad * sizeof(uint32_t))) return;
+
+        auto inicio = chrono::steady_clock::now();
+        vector<string> lote;
+        for (uint32_t i : indices) lote.push_back(rutas[i]);
+        vector<uint64_t> finales;
+        if (!corpus.cargarArchivos(lote, &finales)) return;
+        vector<vector<uint64_t>> posiciones = buscar(corpus.texto());
+
+        vector<uint64_t> respuesta(1);
+        for (size_t p = 0; p < cant_patrones; p++) {
+            vector<uint64_t> conteos = contar_por_archivo(posiciones[p], finales);
+            respuesta.insert(respuesta.end(), conteos.begin(), conteos.end());
+        }
+        respuesta[0] = chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now() - inicio).count();
+        if (!escribir_todo(salida, respuesta.data(), respuesta.size() * sizeof(uint64_t))) return;
+    }
+}
+
+struct Proceso {
+    pid_t pid = -1;
+    int enviar = -1;              // Pipe coordinador -> hijo
+    int recibir = -1;             // Pipe hijo -> coordinador
+    bool activo = false;
+    vector<uint32_t> lote;        // Archivos del lote que está buscando
+    uint64_t bytes_lote = 0;
+    uint64_t archivos = 0, bytes = 0, lotes = 0, lotes_ajenos = 0, ns = 0;
+};
+
+struct Fragmento {
+    deque<uint32_t> pendientes;   // Archivos que todavía no se mandaron a ningún proceso
+    uint64_t bytes_pendientes = 0;
+};
+
+int busqueda_procesos(const string &carpeta, int cantidadArchivos, const vector<string> &patrones,
+                      const string &archivo_patrones, int procesos, const BuscadorCorpus &buscar) {
+
+    if (!fs::is_directory(carpeta)) {
+        cerr << "La ruta especificada no es una carpeta: " << carpeta << endl;
+        return 1;
+    }
+    vector<string> rutas = listar_archivos(carpeta, cantidadArchivos);
+    size_t cant = rutas.size();
+    vector<uint64_t> tam(cant);
+    vector<string> nombres(cant);
+    uint64_t total = 0;
+    for (size_t a = 0; a < cant; a++) {
+        error_code error;
+        tam[a] = fs::file_size(rutas[a], error);
+        if (error) {
+            cerr << "Error al abrir el archivo: " << rutas[a] << endl;
+            return 1;
+        }
+        nombres[a] = fs::path(rutas[a]).filename().string();
+        total += tam[a];
+    }
+    procesos = max(1, min(procesos, (int)max<size_t>(cant, 1)));
+
+    // Fragmentos de tamaño parecido: cada archivo, del más grande al más chico, va al fragmento con menos bytes.
+    // Dentro de cada fragmento los archivos quedan en el orden de la carpeta.
+    vector<Fragmento> fragmentos(procesos);
+    vector<uint32_t> por_tamano(cant);
+    for (size_t a = 0; a < cant; a++) por_tamano[a] = a;
+    stable_sort(por_tamano.begin(), por_tamano.end(), [&](uint32_t x, uint32_t y) { return tam[x] > tam[y]; });
+    priority_queue<pair<uint64_t, int>, vector<pair<uint64_t, int>>, greater<>> menos_cargado;
+    for (int f = 0; f < procesos; f++) menos_cargado.push({0, f});
+    for (uint32_t a : por_tamano) {
+        auto [bytes, f] = menos_cargado.top();
+        menos_cargado.pop();
+        fragmentos[f].pendientes.push_back(a);
+        fragmentos[f].bytes_pendientes += tam[a];
+        menos_cargado.push({bytes + tam[a], f});
+    }
+    for (Fragmento &fragmento : fragmentos) sort(fragmento.pendientes.begin(), fragmento.pendientes.end());
+    uint64_t tamano_lote = clamp(total / (4 * procesos), LOTE_MINIMO, LOTE_MAXIMO);
+
+    // Saca un lote del comienzo del fragmento, o del final si se lo lleva otro proceso
+    auto tomar_lote = [&](Fragmento &fragmento, bool del_final, Proceso &proceso) {
+        proceso.lote.clear();
+        proceso.bytes_lote = 0;
+        while (!fragmento.pendientes.empty()) {
+            uint32_t a = del_final ? fragmento.pendientes.back() : fragmento.pendientes.front();
+            if (!proceso.lote.empty() && proceso.bytes_lote + tam[a] > tamano_lote) break;
+            if (del_final) fragmento.pendientes.pop_back();
+            else fragmento.pendientes.pop_front();
+            fragmento.bytes_pendientes -= tam[a];
+            proceso.lote.push_back(a);
+            proceso.bytes_lote += tam[a];
+        }
+    };
+
+    vector<Proceso> hijos(procesos);
+
+    // Bytes por ns medidos en el proceso de cada fragmento (el promedio si todavía no termina ningún lote)
+    auto velocidad = [&](int f) {
+        if (hijos[f].ns > 0) return (double)hijos[f].bytes / hijos[f].ns;
+        uint64_t bytes = 0, ns = 0;
+        for (const Proceso &hijo : hijos) bytes += hijo.bytes, ns += hijo.ns;
+        return ns > 0 ? (double)bytes / ns : 1.0;
+    };
+
+    // Elige el siguiente lote del proceso w: de su fragmento mientras le queden archivos, y si no, del fragmento
+    // rezagado (el que más tiempo estimado le falta, contando el lote que su proceso está buscando)
+    auto siguiente_lote = [&](int w) {
+        if (!fragmentos[w].pendientes.empty()) {
+            tomar_lote(fragmentos[w], false, hijos[w]);
+            return;
+        }
+        int rezagado = -1;
+        double mayor_restante = 0;
+        for (int f = 0; f < procesos; f++) {
+            if (fragmentos[f].pendientes.empty()) continue;
+            double restante = (fragmentos[f].bytes_pendientes + hijos[f].bytes_lote) / velocidad(f);
+            if (rezagado < 0 || restante > mayor_restante) rezagado = f, mayor_restante = restante;
+        }
+        hijos[w].lote.clear();
+        hijos[w].bytes_lote = 0;
+        if (rezagado < 0) return;
+        tomar_lote(fragmentos[rezagado], true, hijos[w]);
+        hijos[w].lotes_ajenos++;
+    };
+
+    // Manda el siguiente lote al proceso w, o un lote vacío para que termine si ya no quedan archivos
+    auto asignar = [&](int w) {
+        Proceso &hijo = hijos[w];
+        siguiente_lote(w);
+        uint32_t cantidad = hijo.lote.size();
+        bool enviado = escribir_todo(hijo.enviar, &cantidad, sizeof(cantidad)) &&
+                       escribir_todo(hijo.enviar, hijo.lote.data(), cantidad * sizeof(uint32_t));
+        if (cantidad == 0 || !enviado) {
+            close(hijo.enviar);
+            close(hijo.recibir);
+            hijo.activo = false;
+        }
+        return enviado;
+    };
+
+    auto terminar_hijos = [&]() {
+        for (Proceso &hijo : hijos) {
+            if (hijo.activo) {
+                kill(hijo.pid, SIGTERM);
+                close(hijo.enviar);
+                close(hijo.recibir);
+                hijo.activo = false;
+            }
+            if (hijo.pid > 0) waitpid(hijo.pid, nullptr, 0);
+        }
+    };
+
+    // Un hijo que termina antes de tiempo no debe cerrar el coordinador con SIGPIPE al escribirle
+    signal(SIGPIPE, SIG_IGN);
+    cout.flush(); // Lo que quede en el buffer se duplicaría en cada hijo
+
+    startTimer();
+    for (int w = 0; w < procesos; w++) {
+        int hacia_hijo[2], desde_hijo[2];
+        if (pipe(hacia_hijo) < 0 || pipe(desde_hijo) < 0) {
+            cerr << "Error al crear los pipes del proceso " << w + 1 << endl;
+            terminar_hijos();
+            return 1;
+        }
+        pid_t pid = fork();
+        if (pid < 0) {
+            cerr << "Error al crear el proceso " << w + 1 << endl;
+            terminar_hijos();
+            return 1;
+        }
+        if (pid == 0) {
+            // El hijo solo conserva sus dos extremos; los de los hermanos anteriores se cierran
+            for (int v = 0; v < w; v++) close(hijos[v].enviar), close(hijos[v].recibir);
+            close(hacia_hijo[1]);
+            close(desde_hijo[0]);
+            trabajar(hacia_hijo[0], desde_hijo[1], rutas, patrones.size(), buscar);
+            cout.flush();
+            _exit(0);
+        }
+        close(hacia_hijo[0]);
+        close(desde_hijo[1]);
+        hijos[w].pid = pid;
+        hijos[w].enviar = hacia_hijo[1];
+        hijos[w].recibir = desde_hijo[0];
+        hijos[w].activo = true;
+    }
+
+    // conteos[p][a] = ocurrencias del patrón p en el archivo a
+    vector<vector<uint64_t>> conteos(patrones.size(), vector<uint64_t>(cant, 0));
+    bool error = false;
+    for (int w = 0; w < procesos && !error; w++) error = !asignar(w);
+
+    while (!error) {
+        vector<pollfd> esperando;
+        vector<int> indice;
+        for (int w = 0; w < procesos; w++) {
+            if (hijos[w].activo) esperando.push_back({hijos[w].recibir, POLLIN, 0}), indice.push_back(w);
+        }
+        if (esperando.empty()) break;
+        if (poll(esperando.data(), esperando.size(), -1) < 0) {
+            if (errno == EINTR) continue;
+            error = true;
+            break;
+        }
+
+        for (size_t i = 0; i < esperando.size() && !error; i++) {
+            if (esperando[i].revents == 0) continue;
+            Proceso &hijo = hijos[indice[i]];
+            size_t n = hijo.lote.size();
+            vector<uint64_t> respuesta(1 + patrones.size() * n);
+            if (!leer_todo(hijo.recibir, respuesta.data(), respuesta.size() * sizeof(uint64_t))) {
+                cerr << "El proceso " << indice[i] + 1 << " terminó sin responder su lote." << endl;
+                error = true;
+                break;
+            }
+            for (size_t p = 0; p < patrones.size(); p++) {
+                for (size_t k = 0; k < n; k++) conteos[p][hijo.lote[k]] = respuesta[1 + p * n + k];
+            }
+            hijo.archivos += n;
+            hijo.bytes += hijo.bytes_lote;
+            hijo.lotes++;
+            hijo.ns += respuesta[0];
+            if (!asignar(indice[i])) error = true;
+        }
+    }
+    if (error) {
+        terminar_hijos();
+        return 1;
+    }
+    terminar_hijos();
+
+    cout << "\nTiempo de ejecución: ";
+    stopTimer();
+
+    // Mismo reporte que mostrar_resultados con -f
+    if (archivo_patrones.empty()) {
+        cout << "Archivo: " << carpeta << endl;
+        imprimir_conteos(nombres, conteos[0]);
+    } else {
+        cout << "Patrones: " << archivo_patrones << " (" << patrones.size() << ")" << endl;
+        cout << "Archivo: " << carpeta << endl;
+        cout << "\nPatron, Archivo, Ocurrencias" << endl;
+        for (size_t p = 0; p < patrones.size(); p++) {
+            for (size_t a = 0; a < cant; a++) {
+                if (conteos[p][a] > 0) cout << p + 1 << ",  " << nombres[a] << ",  " << conteos[p][a] << endl;
+            }
+        }
+    }
+
+    cout << "\nProceso, Archivos, Bytes, Lotes, Lotes de otros fragmentos, Tiempo de lectura y búsqueda (ns)" << endl;
+    for (int w = 0; w < procesos; w++) {
+        const Proceso &hijo = hijos[w];
+        cout << w + 1 << ",  " << hijo.archivos << ",  " << hijo.bytes << ",  " << hijo.lotes << ",  "
+             << hijo.lotes_ajenos << ",  " << hijo.ns << endl;
+    }
+    return 0;
+}
@@ -0,0 +1,21 @@
+#ifndef COORDINADOR_HPP
+#define COORDINADOR_HPP
+
+#include <string>
+#include <vector>
+#include "cache_resultados.hpp"
+using namespace std;
+
+// Búsqueda en varios procesos (--procesos <N>) para carpetas que no conviene cargar en un solo proceso.
+// El coordinador reparte los archivos en N fragmentos de tamaño parecido (el archivo más grande que queda va
+// al fragmento con menos bytes) y crea N procesos hijos con fork. Cada hijo carga y busca su fragmento
+// por lotes de archivos (cada lote en su propio texto "$archivo1$archivo2...", así la memoria de un proceso
+// no depende del tamaño de la carpeta) y devuelve las ocurrencias por archivo de cada lote por un pipe.
+// Cuando un hijo termina su fragmento, el coordinador busca el fragmento rezagado (el que, según la velocidad
+// medida de su proceso, más tarda en terminar) y le pasa al hijo libre un lote del final de ese fragmento.
+// Al final se imprimen las ocurrencias por archivo como en encuentros_por_archivo y un resumen por proceso.
+// 'buscar' se ejecuta en los hijos, que lo heredan del coordinador con el fork.
+int busqueda_procesos(const string &carpeta, int cantidadArchivos, const vector<string> &patrones,
+                      const string &archivo_patrones, int procesos, const BuscadorCorpus &buscar);
+
+#endif
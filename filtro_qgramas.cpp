@@ -0,0 +1,258 @@
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <unordered_map>
+#include "filtro_qgramas.hpp"
+#include "utils.hpp"
+#include "algoritmos/plegado.hpp"
+
+using namespace std;
+namespace fs = std::filesystem;
+
+// Identifica el formato del archivo de filtros
+static const char MAGIA[8] = {'P', 'A', 'T', 'Q', 'G', 'R', 'M', '1'};
+
+// Con al menos 10 bits del filtro por 3-grama distinto (el largo se redondea a una potencia de 2) y 7 funciones
+// de hash, un 3-grama ausente da un falso positivo menos del 1% de las veces
+static const uint64_t BITS_POR_QGRAMA = 10;
+static const int FUNCIONES_HASH = 7;
+
+struct FiltroArchivo {
+    uint64_t tam = 0;
+    int64_t modificacion = 0;      // Fecha de modificación en ticks del reloj del sistema de archivos
+    vector<uint64_t> bits;         // Filtro de Bloom, con una cantidad de bits potencia de 2 (vacío si no se construyó)
+};
+
+// Agrega un byte al 3-grama rodante (24 bits, con las mayúsculas plegadas)
+static inline uint32_t avanzar(uint32_t qgrama, char c) {
+    return ((qgrama << 8) | TABLA_PLEGADO[static_cast<unsigned char>(c)]) & 0xFFFFFF;
+}
+
+// Mezcla final de MurmurHash3: de ella salen los dos hashes h1 y h2, y el bit i del 3-grama es h1 + i * h2
+static inline uint64_t mezclar(uint64_t x) {
+    x ^= x >> 33;
+    x *= 0xff51afd7ed558ccdULL;
+    x ^= x >> 33;
+    x *= 0xc4ceb9fe1a85ec53ULL;
+    x ^= x >> 33;
+    return x;
+}
+
+static void agregar(vector<uint64_t> &bits, uint32_t qgrama) {
+    uint64_t h = mezclar(qgrama), h2 = (h >> 32) | 1, mascara = bits.size() * 64 - 1;
+    for (int i = 0; i < FUNCIONES_HASH; i++, h += h2) bits[(h & mascara) >> 6] |= 1ULL << (h & 63);
+}
+
+static bool contiene(const vector<uint64_t> &bits, uint32_t qgrama) {
+    uint64_t h = mezclar(qgrama), h2 = (h >> 32) | 1, mascara = bits.size() * 64 - 1;
+    for (int i = 0; i < FUNCIONES_HASH; i++, h += h2) {
+        if (!(bits[(h & mascara) >> 6] >> (h & 63) & 1)) return false;
+    }
+    return true;
+}
+
+// Memoria para construir los filtros, reservada una sola vez para todos los archivos de la carpeta.
+// 'presentes' es el conjunto exacto de 3-gramas del archivo (hay 2^24 posibles, así que cabe en un bitmap de
+// 2 MiB); 'tocadas' son las palabras del bitmap que dejaron de ser cero, que son las únicas que se recorren y
+// se vuelven a limpiar, así un archivo chico no paga por los 2 MiB completos.
+struct MemoriaFiltros {
+    vector<uint64_t> presentes = vector<uint64_t>((1 << 24) / 64, 0);
+    vector<uint32_t> tocadas;
+    vector<char> bloque = vector<char>(1 << 20);
+};
+
+// Lee el archivo por bloques y arma su filtro. Primero se marca el conjunto exacto de 3-gramas
+// para dimensionar el filtro según cuántos distintos tiene.
+static bool construir_filtro(const string &ruta, FiltroArchivo *filtro, MemoriaFiltros *memoria) {
+
+    ifstream file(ruta, ios::binary);
+    if (!file.is_open()) {
+        cerr << "Error al abrir el archivo: " << ruta << endl;
+        return false;
+    }
+
+    vector<uint64_t> &presentes = memoria->presentes;
+    vector<uint32_t> &tocadas = memoria->tocadas;
+    vector<char> &bloque = memoria->bloque;
+    uint32_t qgrama = 0;
+    uint64_t leidos = 0;
+    while (file.read(bloque.data(), bloque.size()) || file.gcount() > 0) {
+        for (streamsize i = 0; i < file.gcount(); i++) {
+            qgrama = avanzar(qgrama, bloque[i]);
+            if (++leidos < 3) continue;
+            uint64_t &palabra = presentes[qgrama >> 6];
+            if (palabra == 0) tocadas.push_back(qgrama >> 6);
+            palabra |= 1ULL << (qgrama & 63);
+        }
+    }
+
+    uint64_t distintos = 0;
+    for (uint32_t w : tocadas) distintos += __builtin_popcountll(presentes[w]);
+    uint64_t largo = 64;
+    while (largo < distintos * BITS_POR_QGRAMA) largo <<= 1;
+
+    filtro->bits.assign(largo / 64, 0);
+    for (uint32_t w : tocadas) {
+        for (uint64_t palabra = presentes[w]; palabra != 0; palabra &= palabra - 1) {
+            agregar(filtro->bits, uint32_t(uint64_t(w) * 64 + __builtin_ctzll(palabra)));
+        }
+        presentes[w] = 0; // Queda limpio para el siguiente archivo
+    }
+    tocadas.clear();
+    return true;
+}
+
+static void escribir_u64(ofstream &out, uint64_t valor) {
+    out.write(reinterpret_cast<const char *>(&valor), sizeof(valor));
+}
+
+static bool leer_u64(ifstream &in, uint64_t *valor) {
+    return bool(in.read(reinterpret_cast<char *>(valor), sizeof(*valor)));
+}
+
+// Carga los filtros guardados. Si no existen o están dañados, se empieza sin filtros (se reconstruyen).
+static unordered_map<string, FiltroArchivo> leer_filtros(const string &ruta) {
+
+    unordered_map<string, FiltroArchivo> filtros;
+    ifstream in(ruta, ios::binary);
+    if (!in.is_open()) return filtros;
+
+    char magia[sizeof(MAGIA)];
+    if (!in.read(magia, sizeof(magia)) || !equal(magia, magia + sizeof(magia), MAGIA)) {
+        cerr << "Filtros con formato desconocido, se reconstruyen: " << ruta << endl;
+        return filtros;
+    }
+
+    uint64_t largo_ruta, modificacion, palabras;
+    while (leer_u64(in, &largo_ruta)) {
+        string archivo(largo_ruta, '\0');
+        FiltroArchivo filtro;
+        // La cantidad de palabras es una potencia de 2 de a lo más 2^24 (el máximo con todos los 3-gramas)
+        if (!in.read(&archivo[0], largo_ruta) || !leer_u64(in, &filtro.tam) || !leer_u64(in, &modificacion) ||
+            !leer_u64(in, &palabras) || palabras == 0 || (palabras & (palabras - 1)) != 0 || palabras > (1 << 24)) {
+            cerr << "Filtros incompletos, se reconstruye el resto: " << ruta << endl;
+            break;
+        }
+        filtro.modificacion = int64_t(modificacion);
+        filtro.bits.resize(palabras);
+        if (!in.read(reinterpret_cast<char *>(filtro.bits.data()), palabras * sizeof(uint64_t))) {
+            cerr << "Filtros incompletos, se reconstruye el resto: " << ruta << endl;
+            break;
+        }
+        filtros[move(archivo)] = move(filtro);
+    }
+    return filtros;
+}
+
+// Reescribe los filtros en un archivo temporal y lo renombra, para no dejarlos a medias si el programa se corta
+static bool escribir_filtros(const string &ruta, const unordered_map<string, FiltroArchivo> &filtros) {
+
+    string temporal = ruta + ".tmp";
+    ofstream out(temporal, ios::binary);
+    if (!out.is_open()) {
+        cerr << "Error al escribir los filtros: " << temporal << endl;
+        return false;
+    }
+
+    out.write(MAGIA, sizeof(MAGIA));
+    for (const auto &[archivo, filtro] : filtros) {
+        escribir_u64(out, archivo.size());
+        out.write(archivo.data(), archivo.size());
+        escribir_u64(out, filtro.tam);
+        escribir_u64(out, uint64_t(filtro.modificacion));
+        escribir_u64(out, filtro.bits.size());
+        out.write(reinterpret_cast<const char *>(filtro.bits.data()), filtro.bits.size() * sizeof(uint64_t));
+    }
+    out.close();
+    if (!out) {
+        cerr << "Error al escribir los filtros: " << temporal << endl;
+        return false;
+    }
+
+    error_code error;
+    fs::rename(temporal, ruta, error);
+    if (error) {
+        cerr << "Error al reemplazar los filtros: " << ruta << endl;
+        return false;
+    }
+    return true;
+}
+
+bool filtrar_archivos(const string &carpeta, int cantidadArchivos, const vector<string> &buscados,
+                      vector<string> *candidatos, EstadisticasFiltro *estadisticas) {
+
+    if (!fs::is_directory(carpeta)) {
+        cerr << "La ruta especificada no es una carpeta: " << carpeta << endl;
+        return false;
+    }
+
+    // 3-gramas distintos de cada texto buscado. Uno de menos de 3 bytes puede estar en cualquier archivo.
+    bool filtrar = !buscados.empty();
+    vector<vector<uint32_t>> qgramas(buscados.size());
+    for (size_t b = 0; b < buscados.size(); b++) {
+        if (buscados[b].size() < 3) filtrar = false;
+        uint32_t qgrama = 0;
+        for (size_t i = 0; i < buscados[b].size(); i++) {
+            qgrama = avanzar(qgrama, buscados[b][i]);
+            if (i >= 2) qgramas[b].push_back(qgrama);
+        }
+        sort(qgramas[b].begin(), qgramas[b].end());
+        qgramas[b].erase(unique(qgramas[b].begin(), qgramas[b].end()), qgramas[b].end());
+    }
+
+    string ruta_filtros = ruta_base(carpeta) + ".qgramas";
+    unordered_map<string, FiltroArchivo> filtros = leer_filtros(ruta_filtros);
+    bool cambiados = false;
+
+    unique_ptr<MemoriaFiltros> memoria; // Se reserva recién cuando hay que construir algún filtro
+    candidatos->clear();
+    for (const string &archivo : listar_archivos(carpeta, cantidadArchivos)) {
+        error_code error_tam, error_fecha;
+        uint64_t tam = fs::file_size(archivo, error_tam);
+        int64_t modificacion = fs::last_write_time(archivo, error_fecha).time_since_epoch().count();
+        if (error_tam || error_fecha) {
+            cerr << "Error al abrir el archivo: " << archivo << endl;
+            return false;
+        }
+        estadisticas->archivos++;
+        estadisticas->bytes += tam;
+
+        // Solo se reconstruye el filtro de los archivos nuevos o modificados
+        FiltroArchivo &filtro = filtros[archivo];
+        if (filtro.bits.empty() || filtro.tam != tam || filtro.modificacion != modificacion) {
+            if (!memoria) memoria = make_unique<MemoriaFiltros>();
+            if (!construir_filtro(archivo, &filtro, memoria.get())) return false;
+            filtro.tam = tam;
+            filtro.modificacion = modificacion;
+            estadisticas->reconstruidos++;
+            cambiados = true;
+        }
+
+        // El archivo se lee si alguno de los textos puede estar en él
+        bool posible = !filtrar || any_of(qgramas.begin(), qgramas.end(), [&](const vector<uint32_t> &buscado) {
+            return all_of(buscado.begin(), buscado.end(), [&](uint32_t qgrama) { return contiene(filtro.bits, qgrama); });
+        });
+        if (posible) {
+            candidatos->push_back(archivo);
+        } else {
+            estadisticas->descartados++;
+            estadisticas->bytes_descartados += tam;
+        }
+    }
+
+    // Se descartan los filtros de archivos que ya no existen
+    for (auto it = filtros.begin(); it != filtros.end();) {
+        error_code error;
+        if (fs::exists(it->first, error)) {
+            ++it;
+        } else {
+            it = filtros.erase(it);
+            cambiados = true;
+        }
+    }
+
+    if (cambiados) escribir_filtros(ruta_filtros, filtros);
+    return true;
+}
@@ -0,0 +1,30 @@
+#ifndef FILTRO_QGRAMAS_HPP
+#define FILTRO_QGRAMAS_HPP
+
+#include <cstdint>
+#include <string>
+#include <vector>
+using namespace std;
+
+// Filtro de q-gramas por archivo (-b) para descartar archivos de una carpeta antes de leerlos.
+// Junto a la carpeta se guarda <carpeta>.qgramas con un filtro de Bloom de los 3-gramas de cada archivo,
+// identificado por su ruta, tamaño y fecha de modificación como en la caché de resultados. Los filtros
+// se construyen la primera vez y se reconstruyen solo para los archivos nuevos o modificados.
+// Un archivo puede contener un patrón solo si su filtro tiene todos los 3-gramas del patrón; si no, se
+// descarta sin leerlo. El filtro puede dar falsos positivos (se lee un archivo de más) pero nunca falsos
+// negativos. Los 3-gramas se guardan con las mayúsculas plegadas, así el mismo filtro sirve para -i.
+
+struct EstadisticasFiltro {
+    uint64_t archivos = 0;           // Archivos de la carpeta
+    uint64_t descartados = 0;        // Archivos que no pueden contener ningún patrón
+    uint64_t bytes = 0;              // Bytes de la carpeta
+    uint64_t bytes_descartados = 0;  // Bytes que no hace falta leer ni buscar
+    uint64_t reconstruidos = 0;      // Filtros construidos en esta ejecución (archivos nuevos o modificados)
+};
+
+// Deja en 'candidatos' las rutas de los archivos de la carpeta (en el orden de listar_archivos) que pueden
+// contener alguno de los textos 'buscados'. Un texto de menos de 3 bytes no descarta ningún archivo.
+bool filtrar_archivos(const string &carpeta, int cantidadArchivos, const vector<string> &buscados,
+                      vector<string> *candidatos, EstadisticasFiltro *estadisticas);
+
+#endif
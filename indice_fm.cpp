@@ -0,0 +1,78 @@
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include "indice_fm.hpp"
+#include "utils.hpp"
+#include "algoritmos/fm_index.hpp"
+
+using namespace std;
+
+int indexar_carpeta(const string &carpeta, int cantidadArchivos) {
+
+    Corpus corpus;
+    vector<uint64_t> pos_final_archivos;
+    if (!corpus.cargarCarpeta(carpeta, &pos_final_archivos, cantidadArchivos)) {
+        cerr << "Error al leer el archivo o carpeta." << endl;
+        return 1;
+    }
+
+    string base = ruta_base(carpeta);
+    startTimer();
+    if (!construirFMIndice(corpus.texto(), base + ".fmi")) return 1;
+    cout << "\nTiempo de construcción: ";
+    stopTimer();
+
+    ofstream manifiesto(base + ".manifiesto");
+    if (!manifiesto.is_open()) {
+        cerr << "Error al crear el manifiesto: " << base + ".manifiesto" << endl;
+        return 1;
+    }
+    for (size_t i = 0; i < pos_final_archivos.size(); i++) {
+        manifiesto << pos_final_archivos[i] << "\t" << corpus.nombres()[i] << "\n";
+    }
+
+    cout << "Índice: " << base + ".fmi" << " (" << corpus.texto().size() << " bytes de texto, "
+         << pos_final_archivos.size() << " archivos)" << endl;
+    return 0;
+}
+
+int buscar_en_indice(const string &carpeta, const vector<string> &patrones, bool varios_patrones) {
+
+    string base = ruta_base(carpeta);
+
+    // Leer el manifiesto con los nombres y las posiciones finales de los archivos
+    ifstream manifiesto(base + ".manifiesto");
+    if (!manifiesto.is_open()) {
+        cerr << "No se encontró el índice de la carpeta. Crearlo con: indexar " << carpeta << endl;
+        return 1;
+    }
+    vector<uint64_t> pos_final_archivos;
+    vector<string> nombres;
+    string linea;
+    while (getline(manifiesto, linea)) {
+        size_t tab = linea.find('\t');
+        if (tab == string::npos) continue;
+        pos_final_archivos.push_back(stoull(linea.substr(0, tab)));
+        nombres.push_back(linea.substr(tab + 1));
+    }
+
+    FMIndice indice;
+    if (!indice.abrir(base + ".fmi")) return 1;
+
+    vector<vector<uint64_t>> posiciones(patrones.size());
+    startTimer();
+    for (size_t p = 0; p < patrones.size(); p++) {
+        posiciones[p] = indice.ubicar(patrones[p]);
+    }
+    cout << "\nTiempo de ejecución: ";
+    stopTimer();
+
+    if (varios_patrones) cout << "Patrones: " << patrones.size() << endl;
+    cout << "Archivo: " << carpeta << endl;
+    if (varios_patrones) {
+        encuentros_por_patron(nombres, posiciones, pos_final_archivos);
+    } else {
+        encuentros_por_archivo(nombres, posiciones[0], pos_final_archivos);
+    }
+    return 0;
+}
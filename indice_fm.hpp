@@ -0,0 +1,19 @@
+#ifndef INDICE_FM_HPP
+#define INDICE_FM_HPP
+
+#include <string>
+#include <vector>
+using namespace std;
+
+// Índice persistente de una carpeta. Junto a la carpeta se escriben dos archivos:
+//   <carpeta>.fmi         índice FM del corpus "$archivo1$archivo2..." que arma Corpus::cargarCarpeta
+//   <carpeta>.manifiesto  una línea "<posición final>\t<nombre>" por archivo
+// Las consultas solo mapean el índice y leen el manifiesto, sin volver a leer los archivos.
+
+// Construye el índice de la carpeta (comando "indexar")
+int indexar_carpeta(const string &carpeta, int cantidadArchivos = -1);
+
+// Busca los patrones en el índice de la carpeta (algoritmo "FM-Index") e imprime las ocurrencias por archivo
+int buscar_en_indice(const string &carpeta, const vector<string> &patrones, bool varios_patrones);
+
+#endif
@@ -1,81 +1,656 @@
 #include <bits/stdc++.h>
-#include "algoritmos/boyer_moore.hpp"
-#include "algoritmos/KMP.hpp"
+#include "algoritmos/comodines.hpp"
+#include "algoritmos/patron_compilado.hpp"
 #include "algoritmos/robin_karp.hpp"
+#include "algoritmos/aho_corasick.hpp"
 #include "utils.hpp"
+#include "busqueda_paralela.hpp"
+#include "busqueda_flujo.hpp"
+#include "indice_fm.hpp"
+#include "cache_resultados.hpp"
+#include "coordinador.hpp"
+#include "filtro_qgramas.hpp"
+#include "posiciones_binarias.hpp"
+#include "memoria.hpp"
+#include "motores.hpp"
+#include "planificador.hpp"
+#include "servidor.hpp"
+#include "tuberia.hpp"
 #include <filesystem>
 #include <iterator>
 using namespace std;
+namespace fs = std::filesystem;
+
+// Muestra qué algoritmo eligió el planificador (Auto) y para cuántos patrones
+static void mostrar_elegidos(const map<string, int> &elegidos, bool modelo_cargado) {
+    cout << "\nAlgoritmos elegidos (modelo " << (modelo_cargado ? ARCHIVO_MODELO : "por defecto") << "): ";
+    bool primero = true;
+    for (const auto &[algoritmo, cantidad] : elegidos) {
+        cout << (primero ? "" : ", ") << algoritmo << " (" << cantidad << ")";
+        primero = false;
+    }
+    cout << endl;
+}
+
+// Busca cada patrón una vez sin contadores (para medir bytes/ns) y otra con SinkEstadisticas, e imprime
+// un CSV con los contadores internos del algoritmo. 'elegir' da el algoritmo de cada patrón.
+static void medir_estadisticas(string_view texto, const vector<string> &patrones,
+                               const function<string(const string &)> &elegir, bool ignorar_mayusculas) {
+    cout << "\nPatron, Algoritmo, Comparaciones, Desplazamientos, Desplazamiento promedio, "
+            "Transiciones de fallo, Colisiones de hash, Bytes/ns" << endl;
+    for (const string &patron : patrones) {
+        string algoritmo = elegir(patron);
+        Buscador buscador = crearBuscador(algoritmo, patron, nullptr, ignorar_mayusculas);
+
+        auto inicio = chrono::high_resolution_clock::now();
+        uint64_t cantidad = buscador.contar(texto);
+        auto fin = chrono::high_resolution_clock::now();
+        long long ns = chrono::duration_cast<chrono::nanoseconds>(fin - inicio).count();
+
+        Estadisticas e = buscador.estadisticas(texto);
+        if (e.coincidencias != cantidad) cerr << "ADVERTENCIA: conteo distinto con contadores para " << patron << endl;
+        double promedio = e.desplazamientos > 0 ? (double)e.total_desplazado / e.desplazamientos : 0;
+        double bytes_ns = ns > 0 ? (double)texto.size() / ns : 0;
+        cout << patron << ",  " << algoritmo << ",  " << e.comparaciones << ",  " << e.desplazamientos << ",  "
+             << promedio << ",  " << e.transiciones_fallo << ",  " << e.colisiones_hash << ",  " << bytes_ns << endl;
+    }
+}
+
+// Modo flujo (-s): cada archivo se lee por bloques y nunca se carga completo en memoria.
+// Imprime la cantidad de ocurrencias por archivo (y por patrón si se usó -p).
+static int busqueda_flujo(const string &algoritmo, const vector<string> &patrones, bool varios_patrones,
+                          const string &flag, const string &ruta, int cantidadArchivos, bool ignorar_mayusculas) {
+
+    vector<string> archivos;
+    if (flag == "-a") {
+        archivos.push_back(ruta);
+    } else {
+        if (!fs::is_directory(ruta)) {
+            cerr << "La ruta especificada no es una carpeta: " << ruta << endl;
+            return 1;
+        }
+        archivos = listar_archivos(ruta, cantidadArchivos);
+    }
+
+    // Con Auto se elige entre los algoritmos que buscan por flujo, con el histograma del comienzo del primer archivo
+    bool automatico = algoritmo == "Auto";
+    Planificador planificador;
+    bool modelo_cargado = automatico && planificador.cargarModelo(ARCHIVO_MODELO);
+    map<string, int> elegidos;
+    uint64_t total = 0;
+    if (automatico && !archivos.empty()) {
+        planificador.muestrearArchivo(archivos[0]);
+        // Solo es una estimación para el planificador: un archivo que no se puede medir no suma (al leerlo se reporta el error)
+        for (const string &archivo : archivos) {
+            error_code error;
+            uint64_t tam = fs::file_size(archivo, error);
+            if (!error) total += tam;
+        }
+    }
+
+    startTimer();
+
+    // conteos[p][a] = ocurrencias del patrón p en el archivo a
+    vector<vector<uint64_t>> conteos(patrones.size());
+    for (size_t p = 0; p < patrones.size(); p++) {
+        string elegido = algoritmo;
+        if (automatico) {
+            elegido = planificador.elegir(patrones[p], total, {"Boyer-Moore", "KMP", "Robin-Karp"});
+            elegidos[elegido]++;
+        }
+        if (!buscarFlujo(archivos, elegido, patrones[p], &conteos[p], ignorar_mayusculas)) return 1;
+    }
+
+    cout << "\nTiempo de ejecución: ";
+    stopTimer();
+
+    if (flag == "-a" && !varios_patrones) {
+        cout << "Cantidad de coincidencias encontradas: " << conteos[0][0] << endl;
+        if (automatico) mostrar_elegidos(elegidos, modelo_cargado);
+        return 0;
+    }
+
+    if (flag == "-f") cout << "Archivo: " << ruta << endl;
+    cout << (varios_patrones ? "\nPatron, Archivo, Ocurrencias" : "\nArchivo, Ocurrencias") << endl;
+    for (size_t p = 0; p < patrones.size(); p++) {
+        for (size_t a = 0; a < archivos.size(); a++) {
+            if (conteos[p][a] == 0) continue;
+            if (varios_patrones) cout << p + 1 << ",  ";
+            cout << fs::path(archivos[a]).filename().string() << ",  " << conteos[p][a] << endl;
+        }
+    }
+    if (automatico) mostrar_elegidos(elegidos, modelo_cargado);
+    return 0;
+}
+
+// Modos que no guardan todas las posiciones (-m), para un solo patrón:
+// conteo: solo la cantidad (por archivo con -f); primera: se detiene en la primera coincidencia;
+// imprimir: muestra cada posición apenas se encuentra.
+static void buscar_modo(const string &modo, const string &flag, const string &ruta, const Corpus &corpus,
+                       const vector<uint64_t> &pos_final_archivos, size_t largo_patron, int hilos,
+                       const Buscador &buscador) {
+
+    string_view texto = corpus.texto();
+    bool carpeta = flag == "-f";
+    const vector<string> &nombres = corpus.nombres();
+
+    // Posición dentro de su archivo: el archivo i empieza después del "$" que sigue al final del archivo i - 1
+    auto posicion_en_archivo = [&](uint64_t pos, size_t archivo) {
+        return pos - (archivo == 0 ? 1 : pos_final_archivos[archivo - 1] + 2);
+    };
+
+    startTimer();
+
+    if (modo == "conteo" && !carpeta) {
+        uint64_t cantidad = contarParalelo(texto, largo_patron, hilos, buscador);
+        cout << "\nTiempo de ejecución: ";
+        stopTimer();
+        cout << "Cantidad de coincidencias encontradas: " << cantidad << endl;
+
+    } else if (modo == "conteo") {
+        // Cada coincidencia suma directamente al conteo de su archivo, sin guardar posiciones
+        vector<uint64_t> conteos(pos_final_archivos.size(), 0);
+        buscador.cada(texto, [&](uint64_t pos) {
+            size_t archivo = archivo_de_posicion(pos, pos_final_archivos);
+            if (archivo < conteos.size()) conteos[archivo]++;
+            return true;
+        });
+        cout << "\nTiempo de ejecución: ";
+        stopTimer();
+        cout << "Archivo: " << ruta << endl;
+        imprimir_conteos(nombres, conteos);
+
+    } else if (modo == "primera") {
+        uint64_t pos = 0;
+        bool encontrada = buscador.primera(texto, &pos);
+        cout << "\nTiempo de ejecución: ";
+        stopTimer();
+        if (!encontrada) {
+            cout << "No se encontraron coincidencias." << endl;
+        } else if (carpeta) {
+            size_t archivo = archivo_de_posicion(pos, pos_final_archivos);
+            cout << "Primera coincidencia: " << nombres[archivo] << ",  " << posicion_en_archivo(pos, archivo) << endl;
+        } else {
+            cout << "Primera coincidencia: " << pos << endl;
+        }
+
+    } else {
+        // imprimir: cada posición sale apenas se encuentra, sin esperar al final de la búsqueda
+        uint64_t cantidad = 0;
+        cout << (carpeta ? "\nArchivo, Posicion" : "\nPosicion") << "\n";
+        buscador.cada(texto, [&](uint64_t pos) {
+            if (carpeta) {
+                size_t archivo = archivo_de_posicion(pos, pos_final_archivos);
+                cout << nombres[archivo] << ",  " << posicion_en_archivo(pos, archivo) << "\n";
+            } else {
+                cout << pos << "\n";
+            }
+            cantidad++;
+            return true;
+        });
+        cout << "\nTiempo de ejecución: ";
+        stopTimer();
+        cout << "Cantidad de coincidencias encontradas: " << cantidad << endl;
+    }
+}
+
+// Muestra las posiciones encontradas: por archivo con -f, o solo las cantidades con -a
+static void mostrar_resultados(const string &archivo_patrones, size_t cant_patrones, const string &flag, const string &ruta,
+                               const vector<vector<uint64_t>> &posiciones, const vector<uint64_t> &pos_final_archivos,
+                               const vector<string> &nombres) {
+
+    if (archivo_patrones.empty()) {
+        if (flag == "-f") {
+            cout << "Archivo: " << ruta << endl;
+            encuentros_por_archivo(nombres, posiciones[0], pos_final_archivos);
+        } else {
+            cout << "Cantidad de coincidencias encontradas: " << posiciones[0].size() << endl;
+        }
+    } else {
+        cout << "Patrones: " << archivo_patrones << " (" << cant_patrones << ")" << endl;
+        if (flag == "-f") {
+            cout << "Archivo: " << ruta << endl;
+            encuentros_por_patron(nombres, posiciones, pos_final_archivos);
+        } else {
+            cout << "\nPatron, Ocurrencias" << endl;
+            for (size_t i = 0; i < posiciones.size(); i++) {
+                cout << i + 1 << ",  " << posiciones[i].size() << endl;
+            }
+        }
+    }
+}
+
+// Guarda las posiciones en el archivo binario de -o, separadas por archivo, y muestra el tiempo de escritura y su tamaño
+static bool guardar_salida(const string &ruta_salida, const vector<string> &patrones, const string &flag, const string &ruta,
+                           uint64_t largo_texto, const vector<vector<uint64_t>> &posiciones,
+                           const vector<uint64_t> &pos_final_archivos, const vector<string> &nombres) {
+
+    // Con -f el archivo i va desde el "$" que lo antecede hasta su posición final; con -a hay un solo archivo
+    vector<string> archivos = nombres;
+    vector<uint64_t> inicios, fines;
+    if (flag == "-f") {
+        for (size_t i = 0; i < pos_final_archivos.size(); i++) {
+            inicios.push_back(i == 0 ? 1 : pos_final_archivos[i - 1] + 2);
+            fines.push_back(pos_final_archivos[i] + 1);
+        }
+    } else {
+        archivos = {fs::path(ruta).filename().string()};
+        inicios = {0};
+        fines = {largo_texto};
+    }
+
+    uint64_t cantidad = 0;
+    for (const vector<uint64_t> &encontradas : posiciones) cantidad += encontradas.size();
+
+    startTimer();
+    uint64_t bytes = guardar_posiciones(ruta_salida, patrones, archivos, inicios, fines, posiciones);
+    if (bytes == 0) return false;
+    cout << "\nTiempo de escritura: ";
+    stopTimer();
+    cout << "Posiciones guardadas en " << ruta_salida << ": " << cantidad << " posiciones, " << bytes << " bytes ("
+         << (cantidad > 0 ? (double)bytes / cantidad : 0) << " bytes por posición)" << endl;
+    return true;
+}
 
 int main(int argc, char *argv[]){
 
-    if (argc < 5) {
+    // Separar las opciones de los argumentos posicionales
+    // -p <ArchivoPatrones>: buscar todos los patrones de un archivo generado por generar_patrones
+    // -j <Hilos>: dividir el texto en trozos y buscarlos en paralelo
+    // --escalamiento: medir el rendimiento con 1, 2, 4, ... hasta <Hilos> hilos
+    // --stats: mostrar los contadores internos de los algoritmos (comparaciones, desplazamientos, ...)
+    // -s: leer los archivos por bloques con memoria acotada (para archivos más grandes que la RAM)
+    // -m <Modo>: todas (por defecto), conteo, primera o imprimir (ver README)
+    // --socket <Ruta>: en modo servidor, escuchar en un socket Unix en vez de la entrada estándar
+    // -r: buscar también en las subcarpetas, leyendo y buscando los archivos en paralelo (tubería)
+    // -w: el patrón admite comodines (?, * y clases [...]; ver algoritmos/comodines.hpp)
+    // -i: no distinguir mayúsculas de minúsculas (A-Z), plegando los bytes al compararlos
+    // -c: usar la caché de resultados por archivo de la carpeta (solo se buscan los archivos nuevos o modificados)
+    // -o <Archivo>: guardar las posiciones encontradas en un archivo binario compacto (ver posiciones_binarias.hpp)
+    // -b: descartar los archivos de la carpeta que no pueden contener los patrones con los filtros de 3-gramas
+    // --memoria: mostrar al final el pico de memoria, las reservas con new y el uso de huge pages
+    // --procesos <N>: repartir los archivos de la carpeta entre N procesos hijos (ver coordinador.hpp)
+    string archivo_patrones;
+    string salida_posiciones;
+    string modo = "todas";
+    int hilos = 1;
+    int procesos = 0;
+    bool medir_escalamiento = false;
+    bool mostrar_estadisticas = false;
+    bool flujo = false;
+    bool usar_cache = false;
+    bool recursivo = false;
+    bool ignorar_mayusculas = false;
+    bool comodines = false;
+    bool usar_filtro = false;
+    string ruta_socket;
+    vector<string> args;
+    for (int i = 1; i < argc; i++) {
+        string arg = argv[i];
+        if (arg == "-p" && i + 1 < argc) {
+            archivo_patrones = argv[++i];
+        } else if (arg == "-j" && i + 1 < argc) {
+            hilos = stoi(argv[++i]);
+            if (hilos < 1) hilos = thread::hardware_concurrency(); // -j 0 usa todos los núcleos
+        } else if (arg == "--procesos" && i + 1 < argc) {
+            procesos = max(1, stoi(argv[++i]));
+        } else if (arg == "--escalamiento") {
+            medir_escalamiento = true;
+        } else if (arg == "--memoria") {
+            reportar_memoria_al_salir();
+        } else if (arg == "--stats") {
+            mostrar_estadisticas = true;
+        } else if (arg == "-s") {
+            flujo = true;
+        } else if (arg == "--socket" && i + 1 < argc) {
+            ruta_socket = argv[++i];
+        } else if (arg == "-r") {
+            recursivo = true;
+        } else if (arg == "-w") {
+            comodines = true;
+        } else if (arg == "-i") {
+            ignorar_mayusculas = true;
+        } else if (arg == "-b") {
+            usar_filtro = true;
+        } else if (arg == "-c") {
+            usar_cache = true;
+        } else if (arg == "-o" && i + 1 < argc) {
+            salida_posiciones = argv[++i];
+        } else if (arg == "-m" && i + 1 < argc) {
+            modo = argv[++i];
+        } else {
+            args.push_back(arg);
+        }
+    }
+
+    // Comando para medir los algoritmos en esta máquina y guardar el modelo de costos de "Auto"
+    if (!args.empty() && args[0] == "calibrar") {
+        if (args.size() < 2) {
+            cerr << "Uso: " << argv[0] << " calibrar <CarpetaOArchivo>" << endl;
+            return 1;
+        }
+        return calibrar_modelo(args[1]);
+    }
+
+    // Comando para dejar la carpeta cargada y responder consultas (ver servidor.hpp)
+    if (!args.empty() && args[0] == "servidor") {
+        if (args.size() < 2) {
+            cerr << "Uso: " << argv[0] << " servidor <Carpeta> <CantidadArchivos> [--socket <Ruta>]" << endl;
+            return 1;
+        }
+        return servidor(args[1], args.size() > 2 ? stoi(args[2]) : -1, ruta_socket);
+    }
+
+    // Comando para mostrar un archivo de posiciones guardado con -o
+    if (!args.empty() && args[0] == "leer") {
+        if (args.size() < 2) {
+            cerr << "Uso: " << argv[0] << " leer <ArchivoPosiciones>" << endl;
+            return 1;
+        }
+        return imprimir_posiciones(args[1]);
+    }
+
+    // Comando para construir el índice FM de una carpeta
+    if (!args.empty() && args[0] == "indexar") {
+        if (args.size() < 2) {
+            cerr << "Uso: " << argv[0] << " indexar <Carpeta> <CantidadArchivos>" << endl;
+            return 1;
+        }
+        return indexar_carpeta(args[1], args.size() > 2 ? stoi(args[2]) : -1);
+    }
+
+    // Con -p los patrones se leen del archivo, por lo que <Patron> no va como argumento
+    size_t minimo_args = archivo_patrones.empty() ? 4 : 3;
+    if (args.size() < minimo_args) {
         cerr << "Uso: " << argv[0] << " <algoritmo> <Patron> -<flag> <CarpetaConArchivosEntrada> <CantidadArchivos>" << endl;
+        cerr << "     " << argv[0] << " <algoritmo> -p <ArchivoPatrones> -<flag> <CarpetaConArchivosEntrada> <CantidadArchivos>" << endl;
         return 1;
     }
 
     // Obtener el nombre del algoritmo y el archivo de entrada
     // si el flag es -f, se busca en carpetas
     // si el flag es -a, se busca en archivos 
-    string algoritmo = argv[1];
-    string patron = argv[2];
-    string flag = argv[3];
+    size_t k = 0;
+    string algoritmo = args[k++];
+    vector<string> patrones;
+    if (archivo_patrones.empty()) {
+        patrones.push_back(args[k++]);
+    } else if (!leerPatrones(archivo_patrones, &patrones)) {
+        return 1;
+    }
+    string flag = args[k++];
     if (flag != "-f" && flag != "-a") {
         cerr << "Flag no reconocido. Ingresar -f para buscar en carpetas o -a para buscar en archivos." << endl;
         return 1;
     }
-    string nombre_archivo_carpeta = argv[4];
-    string texto;
+    string nombre_archivo_carpeta = args[k++];
+
+    if (modo != "todas" && modo != "conteo" && modo != "primera" && modo != "imprimir") {
+        cerr << "Modo no reconocido. Ingresar alguno de los siguientes: todas, conteo, primera, imprimir" << endl;
+        return 1;
+    }
+    if (modo != "todas" && (!archivo_patrones.empty() || flujo || algoritmo == "FM-Index" || algoritmo == "Aho-Corasick")) {
+        cerr << "El modo " << modo << " solo se usa con un patrón y los algoritmos de un patrón." << endl;
+        return 1;
+    }
+
+    if (!salida_posiciones.empty() && (modo != "todas" || flujo || recursivo || medir_escalamiento ||
+                                       mostrar_estadisticas || algoritmo == "FM-Index")) {
+        cerr << "Las posiciones (-o) solo se guardan con el modo todas, sin -s, -r, --escalamiento, --stats ni FM-Index." << endl;
+        return 1;
+    }
+
+    if (procesos > 0 && (flag != "-f" || modo != "todas" || flujo || recursivo || usar_cache || medir_escalamiento ||
+                         mostrar_estadisticas || !salida_posiciones.empty() || algoritmo == "FM-Index")) {
+        cerr << "La búsqueda en varios procesos (--procesos) solo se usa con -f y el modo todas, sin -s, -r, -c, -o, "
+                "--escalamiento, --stats ni FM-Index." << endl;
+        return 1;
+    }
+
+    if (usar_filtro && (flag != "-f" || flujo || recursivo || usar_cache || procesos > 0 || algoritmo == "FM-Index")) {
+        cerr << "Los filtros de 3-gramas (-b) solo se usan con -f, sin -s, -r, -c, --procesos ni FM-Index." << endl;
+        return 1;
+    }
+
+    // Con -w se revisa la sintaxis de todos los patrones antes de leer el texto
+    if (comodines) {
+        // La caché descarta las coincidencias que cruzan al archivo siguiente según el largo del patrón, que con
+        // comodines no es el del texto del patrón (y con * es variable)
+        if (algoritmo == "FM-Index" || algoritmo == "Aho-Corasick" || flujo || mostrar_estadisticas || usar_cache) {
+            cerr << "Los comodines (-w) solo se usan con los algoritmos de un patrón o Auto, sin -s, -c ni --stats." << endl;
+            return 1;
+        }
+        for (const string &patron : patrones) {
+            if (patron.empty()) continue; // Registro vacío del archivo de patrones: no tiene coincidencias
+            PatronComodin comodin(patron);
+            if (!comodin.valido()) {
+                cerr << "Patrón no válido (" << patron << "): " << comodin.error() << endl;
+                return 1;
+            }
+        }
+    }
+    // Largo de las coincidencias de un patrón, para dividir el texto en trozos que se traslapan (-j).
+    // Un patrón con '*' no tiene largo fijo y se busca en un solo trozo (largo 0).
+    auto largo_busqueda = [&](const string &patron) {
+        return comodines ? PatronComodin(patron).largoFijo() : patron.size();
+    };
+
+    // Con el índice FM no se lee el texto, solo el índice ya construido
+    if (algoritmo == "FM-Index") {
+        if (ignorar_mayusculas) {
+            cerr << "FM-Index no admite -i: el índice se construye con los bytes exactos del texto." << endl;
+            return 1;
+        }
+        if (flag != "-f") {
+            cerr << "FM-Index solo busca en carpetas indexadas (-f)." << endl;
+            return 1;
+        }
+        return buscar_en_indice(nombre_archivo_carpeta, patrones, !archivo_patrones.empty());
+    }
+
+    if (recursivo) {
+        if (flag != "-f" || modo != "todas" || usar_cache || flujo || mostrar_estadisticas || medir_escalamiento) {
+            cerr << "La búsqueda recursiva (-r) solo se usa con -f, sin -m, -c, -s, --stats ni --escalamiento." << endl;
+            return 1;
+        }
+        int cantidad = args.size() > k ? stoi(args[k]) : -1;
+        return busqueda_recursiva(nombre_archivo_carpeta, cantidad, algoritmo, patrones, !archivo_patrones.empty(), hilos,
+                                  ignorar_mayusculas, comodines);
+    }
+
+    if (flujo) {
+        int cantidad = args.size() > k ? stoi(args[k]) : -1;
+        return busqueda_flujo(algoritmo, patrones, !archivo_patrones.empty(), flag, nombre_archivo_carpeta, cantidad,
+                              ignorar_mayusculas);
+    }
+
+    // Algoritmo de un solo patrón a usar. 'preparar' calcula una vez las tablas del patrón
+    // y devuelve un buscador que las reutiliza en cada trozo de texto.
+    // Con "Auto" el planificador elige el algoritmo de cada patrón según el modelo de costos.
+    bool automatico = algoritmo == "Auto";
+    Planificador planificador;
+    bool modelo_cargado = automatico && planificador.cargarModelo(ARCHIVO_MODELO);
+    map<string, int> elegidos;          // Algoritmos elegidos por el planificador y cuántos patrones buscó cada uno
+    uint64_t largo_estimado = 0;        // Largo del texto con el que el planificador estima los costos
+    function<Buscador(const string &)> preparar;
+    atomic<uint64_t> colisiones(0); // Coincidencias falsas de hash en Robin-Karp
+    if (esMotor(algoritmo)) {
+        preparar = [&](const string &patron) {
+            return crearBuscador(algoritmo, patron, &colisiones, ignorar_mayusculas, comodines);
+        };
+    } else if (automatico) {
+        preparar = [&](const string &patron) {
+            // Con comodines se elige el algoritmo que busca el factor literal
+            string buscado = comodines ? PatronComodin(patron).factor() : patron;
+            string elegido = planificador.elegir(buscado.empty() ? patron : buscado, largo_estimado);
+            elegidos[elegido]++;
+            return crearBuscador(elegido, patron, &colisiones, ignorar_mayusculas, comodines);
+        };
+    } else if (algoritmo != "Aho-Corasick") {
+        cerr << "Algoritmo no reconocido. Ingresar alguno de los siguientes: Boyer-Moore, Horspool, KMP, KMP-DFA, Robin-Karp, SIMD, Shift-Or, BNDM, Aho-Corasick, Auto" << endl;
+        return 1;
+    }
+
+    // Búsqueda de todos los patrones sobre un texto "$archivo1$archivo2..." (o un archivo individual)
+    auto buscar_todos = [&](string_view texto) {
+        vector<vector<uint64_t>> posiciones(patrones.size());
+        if (algoritmo == "Aho-Corasick" || (automatico && patrones.size() > 1 && !comodines && planificador.preferirAhoCorasick(patrones, texto.size()))) {
+            if (automatico) elegidos["Aho-Corasick"] = patrones.size();
+            // Una sola pasada sobre el texto para todos los patrones
+            posiciones = ahoCorasick(texto, patrones, ignorar_mayusculas);
+        } else if (algoritmo == "Robin-Karp" && patrones.size() > 1 && hilos <= 1 && !ignorar_mayusculas && !comodines) {
+            // Una pasada por cada largo distinto, consultando los hashes de los patrones en una tabla
+            uint64_t falsas = 0;
+            posiciones = robinKarpMultiple(texto, patrones, &falsas);
+            colisiones += falsas;
+        } else {
+            // Una pasada por patrón, dividida en trozos si se pidieron varios hilos. Los buffers de los trozos
+            // se reutilizan en todos los patrones y se liberan al terminar la búsqueda.
+            vector<vector<uint64_t>> trozos;
+            for (size_t i = 0; i < patrones.size(); i++) {
+                buscarParalelo(texto, largo_busqueda(patrones[i]), hilos, preparar(patrones[i]), &posiciones[i], &trozos);
+            }
+        }
+        return posiciones;
+    };
+
+    vector<vector<uint64_t>> posiciones; // Posiciones encontradas para cada patrón
+    vector<uint64_t> pos_final_archivos; // Posiciones del final de los archivos leídos
+    vector<string> nombres;              // Nombres de los archivos, en el mismo orden
+
+    if (procesos > 0) {
+        // Cada proceso hijo busca sus lotes de archivos con buscar_todos, que hereda con el fork
+        return busqueda_procesos(nombre_archivo_carpeta, args.size() > k ? stoi(args[k]) : -1, patrones, archivo_patrones,
+                                 procesos, [&](string_view texto) {
+                                     if (automatico) {
+                                         planificador.muestrear(texto);
+                                         largo_estimado = texto.size();
+                                     }
+                                     return buscar_todos(texto);
+                                 });
+    }
+
+    if (usar_cache) {
+        // Solo se leen y buscan los archivos nuevos o modificados; el resto sale de la caché
+        if (flag != "-f" || modo != "todas" || medir_escalamiento || mostrar_estadisticas) {
+            cerr << "La caché (-c) solo se usa con -f, sin -m, --escalamiento ni --stats." << endl;
+            return 1;
+        }
+        EstadisticasCache estadisticas;
+        startTimer();
+        // Los resultados con -i se guardan aparte de los exactos (-c no se usa con -w)
+        string clave_algoritmo = algoritmo + (ignorar_mayusculas ? " -i" : "");
+        if (!buscar_con_cache(nombre_archivo_carpeta, args.size() > k ? stoi(args[k]) : -1, clave_algoritmo, patrones,
+                              [&](string_view texto) {
+                                  // Con Auto se planifica con los archivos que de verdad hay que buscar
+                                  if (automatico) {
+                                      planificador.muestrear(texto);
+                                      largo_estimado = texto.size();
+                                  }
+                                  return buscar_todos(texto);
+                              }, &posiciones, &pos_final_archivos, &nombres, &estadisticas)) {
+            return 1;
+        }
+        cout << "\nTiempo de ejecución: ";
+        stopTimer();
+        mostrar_resultados(archivo_patrones, patrones.size(), flag, nombre_archivo_carpeta, posiciones, pos_final_archivos, nombres);
+        if (!salida_posiciones.empty() && !guardar_salida(salida_posiciones, patrones, flag, nombre_archivo_carpeta, 0,
+                                                          posiciones, pos_final_archivos, nombres)) {
+            return 1;
+        }
+        if (automatico) mostrar_elegidos(elegidos, modelo_cargado);
+        cout << "\nCaché: " << estadisticas.aciertos << " aciertos, " << estadisticas.fallos << " fallos, "
+             << estadisticas.archivos_leidos << " archivos leídos de " << nombres.size() << endl;
+        if (algoritmo == "Robin-Karp") cout << "\nColisiones de hash (verificaciones falsas): " << colisiones << endl;
+        return 0;
+    }
+
+    Corpus corpus;
     
     // Leer el archivo de entrada
     // Si se especifica una cantidad de archivos, se lee esa cantidad
 
-    vector<int> pos_final_archivos; // Vector para almacenar las posiciones del final de los archivos leídos
-    if (argc > 5 && flag == "-f") {
-        texto = readFolder(nombre_archivo_carpeta, &pos_final_archivos, stoi(argv[5]));
+    bool leido = false;
+    if (usar_filtro) {
+        // Solo se leen los archivos cuyo filtro tiene todos los 3-gramas de algún patrón (con -w, de su factor literal)
+        vector<string> buscados, candidatos;
+        for (const string &patron : patrones) buscados.push_back(comodines ? PatronComodin(patron).factor() : patron);
+        EstadisticasFiltro estadisticas;
+        startTimer();
+        leido = filtrar_archivos(nombre_archivo_carpeta, args.size() > k ? stoi(args[k]) : -1, buscados, &candidatos,
+                                 &estadisticas);
+        if (leido) {
+            cout << "\nTiempo de filtrado: ";
+            stopTimer();
+            cout << "Filtros de 3-gramas: " << estadisticas.descartados << " de " << estadisticas.archivos
+                 << " archivos descartados (" << estadisticas.bytes_descartados << " de " << estadisticas.bytes
+                 << " bytes sin leer), " << estadisticas.reconstruidos << " filtros construidos" << endl;
+            leido = corpus.cargarArchivos(candidatos, &pos_final_archivos);
+        }
+    } else if (args.size() > k && flag == "-f") {
+        leido = corpus.cargarCarpeta(nombre_archivo_carpeta, &pos_final_archivos, stoi(args[k]));
     } else if (flag == "-f") {
-        texto = readFolder(nombre_archivo_carpeta, &pos_final_archivos);
+        leido = corpus.cargarCarpeta(nombre_archivo_carpeta, &pos_final_archivos);
     } else if (flag == "-a") {
-        texto = readFile(nombre_archivo_carpeta);
-    } else {
+        leido = corpus.cargarArchivo(nombre_archivo_carpeta);
+    }
+    if (!leido) {
         cerr << "Error al leer el archivo o carpeta." << endl;
         return 1;
     }
+    string_view texto = corpus.texto(); // Vista del corpus, sin copias
+    if (automatico) {
+        planificador.muestrear(texto);
+        largo_estimado = texto.size();
+    }
 
-    vector<int> posiciones;
-    // Ordenar los datos según el algoritmo especificado
-    if (algoritmo == "Boyer-Moore") {
-        startTimer();
-
-        posiciones = boyer_moore(texto, patron);
+    if (medir_escalamiento) {
+        if (!preparar) {
+            cerr << "El escalamiento solo se mide con Boyer-Moore, Horspool, KMP, KMP-DFA, Robin-Karp, SIMD, Shift-Or, BNDM o Auto." << endl;
+            return 1;
+        }
+        escalamiento(texto, largo_busqueda(patrones[0]), max(hilos, 1), preparar(patrones[0]));
+        return 0;
+    }
 
-    } else if (algoritmo == "KMP") {
-        startTimer();
+    if (mostrar_estadisticas) {
+        if (!preparar) {
+            cerr << "Los contadores (--stats) solo se miden con Boyer-Moore, Horspool, KMP, KMP-DFA, Robin-Karp, SIMD, Shift-Or, BNDM o Auto." << endl;
+            return 1;
+        }
+        medir_estadisticas(texto, patrones, [&](const string &patron) {
+            return automatico ? planificador.elegir(patron, largo_estimado) : algoritmo;
+        }, ignorar_mayusculas);
+        return 0;
+    }
 
-        posiciones = KMP(patron,texto);
-        // Implementar KMP aquí
-    } else if (algoritmo == "Robin-Karp") {
-        startTimer();
+    // Con -a y un patrón solo se muestra la cantidad, así que no hace falta guardar las posiciones (salvo con -o)
+    if (modo == "todas" && flag == "-a" && archivo_patrones.empty() && preparar && salida_posiciones.empty()) modo = "conteo";
 
-        posiciones = robinKarp(texto, patron);
-    
-    } else {
-        cerr << "Algoritmo no reconocido. Ingresar alguno de los siguientes: Boyer-Moore, KMP, Robin-Karp" << endl;
-        return 1;
+    if (modo != "todas") {
+        buscar_modo(modo, flag, nombre_archivo_carpeta, corpus, pos_final_archivos, largo_busqueda(patrones[0]), hilos,
+                    preparar(patrones[0]));
+        if (automatico) mostrar_elegidos(elegidos, modelo_cargado);
+        if (algoritmo == "Robin-Karp") cout << "\nColisiones de hash (verificaciones falsas): " << colisiones << endl;
+        return 0;
     }
 
+    startTimer();
+    posiciones = buscar_todos(texto);
     cout << "\nTiempo de ejecución: ";
     stopTimer();
 
-    // Mostrar las posiciones encontradas por archivo
-
-    if (flag == "-f") {
-        cout << "Archivo: " << nombre_archivo_carpeta << endl;
-        encuentros_por_archivo(nombre_archivo_carpeta, posiciones, pos_final_archivos);
-    } else {
-        cout << "Cantidad de coincidencias encontradas: " << posiciones.size() << endl;
+    mostrar_resultados(archivo_patrones, patrones.size(), flag, nombre_archivo_carpeta, posiciones, pos_final_archivos,
+                       corpus.nombres());
+    if (!salida_posiciones.empty() && !guardar_salida(salida_posiciones, patrones, flag, nombre_archivo_carpeta, texto.size(),
+                                                      posiciones, pos_final_archivos, corpus.nombres())) {
+        return 1;
     }
+    if (automatico) mostrar_elegidos(elegidos, modelo_cargado);
 
+    if (algoritmo == "Robin-Karp") {
+        cout << "\nColisiones de hash (verificaciones falsas): " << colisiones << endl;
+    }
 
     return 0;
-}
\ No newline at end of file
+}
@@ -0,0 +1,141 @@
+#include <atomic>
+#include <cctype>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <new>
+#include <string>
+#include <sys/mman.h>
+#include <sys/resource.h>
+#include "memoria.hpp"
+
+using namespace std;
+
+// Tamaño de una huge page (x86-64 y arm64 con páginas base de 4 KiB)
+static const size_t HUGE_PAGE = 2 << 20;
+
+static atomic<uint64_t> reservas{0};
+static atomic<uint64_t> bytes_reservados{0};
+static atomic<uint64_t> regiones_arena{0};
+static atomic<uint64_t> arenas_reutilizadas{0};
+static atomic<uint64_t> huge_pages_kib{0};
+// Solo con --memoria se cuentan las reservas y las arenas anotan sus huge pages al llenarse. Se inicializa
+// en cero antes que cualquier constructor estático, así que sirve también para las reservas previas a main.
+static atomic<bool> reportar{false};
+
+// Operator new global que cuenta las reservas para --memoria. Sin --memoria solo agrega una lectura relajada
+// de 'reportar' (que no cambia después de leer las opciones) antes de llamar a malloc.
+void *operator new(size_t bytes) {
+    if (reportar.load(memory_order_relaxed)) {
+        reservas.fetch_add(1, memory_order_relaxed);
+        bytes_reservados.fetch_add(bytes, memory_order_relaxed);
+    }
+    if (void *p = malloc(bytes ? bytes : 1)) return p;
+    throw bad_alloc();
+}
+
+void *operator new[](size_t bytes) { return operator new(bytes); }
+
+void *operator new(size_t bytes, const nothrow_t &) noexcept {
+    if (reportar.load(memory_order_relaxed)) {
+        reservas.fetch_add(1, memory_order_relaxed);
+        bytes_reservados.fetch_add(bytes, memory_order_relaxed);
+    }
+    return malloc(bytes ? bytes : 1);
+}
+
+void *operator new[](size_t bytes, const nothrow_t &etiqueta) noexcept { return operator new(bytes, etiqueta); }
+
+void operator delete(void *p) noexcept { free(p); }
+void operator delete[](void *p) noexcept { free(p); }
+void operator delete(void *p, size_t) noexcept { free(p); }
+void operator delete[](void *p, size_t) noexcept { free(p); }
+
+// KiB de la región que empieza en 'inicio' respaldados con huge pages, según /proc/self/smaps
+static uint64_t huge_pages_de_region(const void *inicio) {
+    ifstream smaps("/proc/self/smaps");
+    string linea;
+    bool dentro = false;
+    while (getline(smaps, linea)) {
+        // Las líneas de encabezado de cada región empiezan con "<inicio>-<fin>" en hexadecimal
+        size_t guion = linea.find('-');
+        if (guion != string::npos && guion > 0 && linea.find(' ') > guion && isxdigit(static_cast<unsigned char>(linea[0]))) {
+            dentro = strtoull(linea.c_str(), nullptr, 16) == reinterpret_cast<uintptr_t>(inicio);
+        } else if (dentro && linea.rfind("AnonHugePages:", 0) == 0) {
+            return strtoull(linea.c_str() + 14, nullptr, 10);
+        }
+    }
+    return 0;
+}
+
+Arena::~Arena() {
+    liberar();
+}
+
+char *Arena::reservar(size_t bytes) {
+
+    if (inicio != nullptr && bytes <= cap) {
+        arenas_reutilizadas.fetch_add(1, memory_order_relaxed);
+        return inicio;
+    }
+    liberar();
+
+    // Se mapea una huge page de más para poder alinear el comienzo. MAP_NORESERVE: las páginas se asignan
+    // recién al escribirlas, así que la parte no usada de la región no ocupa memoria.
+    size_t pedido = ((bytes ? bytes : 1) + HUGE_PAGE - 1) / HUGE_PAGE * HUGE_PAGE;
+    void *p = mmap(nullptr, pedido + HUGE_PAGE, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+    if (p == MAP_FAILED) {
+        cerr << "Error al reservar " << bytes << " bytes para la arena." << endl;
+        return nullptr;
+    }
+    region = p;
+    largo_region = pedido + HUGE_PAGE;
+    inicio = reinterpret_cast<char *>((reinterpret_cast<uintptr_t>(p) + HUGE_PAGE - 1) / HUGE_PAGE * HUGE_PAGE);
+    cap = pedido;
+    madvise(inicio, cap, MADV_HUGEPAGE); // Si el kernel no tiene THP sigue funcionando con páginas normales
+    regiones_arena.fetch_add(1, memory_order_relaxed);
+    return inicio;
+}
+
+void Arena::liberar() {
+    if (region == nullptr) return;
+
+    munmap(region, largo_region);
+    region = nullptr;
+    largo_region = 0;
+    inicio = nullptr;
+    cap = 0;
+}
+
+void Arena::anotarHugePages() const {
+    if (region == nullptr || !reportar.load(memory_order_relaxed)) return;
+
+    // Con MADV_HUGEPAGE la parte alineada queda como una región aparte en smaps, que empieza en 'inicio'
+    uint64_t kib = huge_pages_de_region(inicio);
+    uint64_t anterior = huge_pages_kib.load();
+    while (kib > anterior && !huge_pages_kib.compare_exchange_weak(anterior, kib)) {}
+}
+
+UsoMemoria uso_memoria() {
+    UsoMemoria uso;
+    uso.reservas = reservas.load();
+    uso.bytes_reservados = bytes_reservados.load();
+    rusage datos{};
+    if (getrusage(RUSAGE_SELF, &datos) == 0) uso.pico_kib = datos.ru_maxrss; // En Linux, ru_maxrss está en KiB
+    uso.regiones_arena = regiones_arena.load();
+    uso.arenas_reutilizadas = arenas_reutilizadas.load();
+    uso.huge_pages_kib = huge_pages_kib.load();
+    return uso;
+}
+
+static void imprimir_memoria() {
+    UsoMemoria uso = uso_memoria();
+    cout << "\nMemoria: pico " << uso.pico_kib << " KiB, " << uso.reservas << " reservas con new ("
+         << uso.bytes_reservados << " bytes), " << uso.regiones_arena << " regiones de arena ("
+         << uso.arenas_reutilizadas << " reutilizadas), " << uso.huge_pages_kib << " KiB en huge pages" << endl;
+}
+
+void reportar_memoria_al_salir() {
+    reportar.store(true, memory_order_relaxed);
+    atexit(imprimir_memoria);
+}
@@ -0,0 +1,53 @@
+#ifndef MEMORIA_HPP
+#define MEMORIA_HPP
+
+#include <cstddef>
+#include <cstdint>
+using namespace std;
+
+// Región de memoria para los textos grandes (la arena de Corpus). Se reserva con mmap anónimo, alineada
+// a 2 MiB y marcada con MADV_HUGEPAGE para que el kernel la respalde con páginas de 2 MiB (transparent
+// huge pages): al recorrer varios GB de texto hay un fallo de TLB cada 2 MiB en vez de cada 4 KiB.
+// A diferencia de un string, reservar no llena la región con ceros, y si la siguiente carga cabe en la
+// región ya reservada se reutiliza sin volver a pedir memoria al sistema.
+// Solo el texto de -f usa la arena: los vectores de resultados y los buffers de cada consulta (servidor,
+// -r, -j) siguen saliendo del heap normal.
+class Arena {
+public:
+    Arena() = default;
+    ~Arena();
+    Arena(const Arena &) = delete;
+    Arena &operator=(const Arena &) = delete;
+
+    // Devuelve al menos 'bytes' bytes escribibles (el contenido anterior no se conserva), o nullptr si falla
+    char *reservar(size_t bytes);
+    void liberar();
+    // Con --memoria, anota cuántos KiB de la región quedaron en huge pages. Las páginas se asignan al
+    // escribirlas, así que se llama apenas se termina de llenar la región, no al liberarla.
+    void anotarHugePages() const;
+    size_t capacidad() const { return cap; }
+
+private:
+    void *region = nullptr;  // Región completa devuelta por mmap
+    size_t largo_region = 0;
+    char *inicio = nullptr;  // Comienzo alineado a 2 MiB dentro de la región
+    size_t cap = 0;
+};
+
+// Uso de memoria del proceso (--memoria)
+struct UsoMemoria {
+    uint64_t reservas = 0;             // Llamadas a new desde --memoria (contadas con el operator new global de memoria.cpp)
+    uint64_t bytes_reservados = 0;     // Bytes pedidos con new desde --memoria
+    uint64_t pico_kib = 0;             // Pico de memoria residente (getrusage)
+    uint64_t regiones_arena = 0;       // Regiones mapeadas por las arenas
+    uint64_t arenas_reutilizadas = 0;  // Cargas que cupieron en una región ya mapeada
+    uint64_t huge_pages_kib = 0;       // Máximo respaldado con huge pages en una región de arena
+};
+
+UsoMemoria uso_memoria();
+
+// Empieza a contar las reservas con new e imprime el uso de memoria al terminar el programa (con atexit,
+// para cubrir cualquier salida de main)
+void reportar_memoria_al_salir();
+
+#endif
@@ -0,0 +1,29 @@
+#include <memory>
+#include "motores.hpp"
+#include "algoritmos/comodines.hpp"
+#include "algoritmos/patron_compilado.hpp"
+
+using namespace std;
+
+const vector<string> MOTORES = {"Boyer-Moore", "Horspool", "KMP", "KMP-DFA", "Robin-Karp", "SIMD", "Shift-Or", "BNDM"};
+
+bool esMotor(const string &algoritmo) {
+    for (const string &motor : MOTORES) {
+        if (motor == algoritmo) return true;
+    }
+    return false;
+}
+
+// El patrón se compila una sola vez y lo comparten todos los trozos (y los hilos).
+// Un patrón vacío (registro vacío de -p) se busca como literal, sin coincidencias, también con comodines.
+Buscador crearBuscador(const string &algoritmo, const string &patron, atomic<uint64_t> *colisiones,
+                       bool ignorarMayusculas, bool comodines) {
+    if (comodines && !patron.empty()) {
+        auto comodin = make_shared<PatronComodin>(patron, algoritmo, ignorarMayusculas);
+        if (!comodin->valido()) return Buscador();
+        return hacerBuscador([comodin](string_view txt, auto &sink) { comodin->buscar(txt, sink); });
+    }
+    auto compilado = make_shared<PatronCompilado>(algoritmo, patron, ignorarMayusculas, colisiones);
+    if (!compilado->valido()) return Buscador();
+    return hacerBuscador([compilado](string_view txt, auto &sink) { compilado->buscar(txt, sink); });
+}
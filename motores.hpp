@@ -0,0 +1,23 @@
+#ifndef MOTORES_HPP
+#define MOTORES_HPP
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "busqueda_paralela.hpp"
+using namespace std;
+
+// Algoritmos de un solo patrón que se pueden preparar como Buscador
+extern const vector<string> MOTORES;
+
+bool esMotor(const string &algoritmo);
+
+// Calcula una vez las tablas del patrón para el algoritmo y devuelve un Buscador que las reutiliza
+// en cada trozo de texto. Robin-Karp suma a 'colisiones' (si no es nulo) sus coincidencias falsas de hash.
+// Con ignorarMayusculas (-i) el patrón se pliega y el texto se compara a través de la tabla de plegado.
+// Con comodines (-w) el patrón usa la sintaxis de PatronComodin y 'algoritmo' busca su factor literal.
+Buscador crearBuscador(const string &algoritmo, const string &patron, atomic<uint64_t> *colisiones = nullptr,
+                       bool ignorarMayusculas = false, bool comodines = false);
+
+#endif
@@ -0,0 +1,293 @@
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include "planificador.hpp"
+#include "utils.hpp"
+#include "algoritmos/aho_corasick.hpp"
+
+using namespace std;
+namespace fs = std::filesystem;
+
+const string ARCHIVO_MODELO = "modelo_costos.txt";
+
+// Muestreo del histograma: hasta BLOQUES_MUESTRA bloques de LARGO_BLOQUE bytes repartidos por el texto
+constexpr size_t BLOQUES_MUESTRA = 256;
+constexpr size_t LARGO_BLOQUE = 4096;
+
+// Calibración: texto de a lo más TAMANO_CALIBRACION bytes y PATRONES_POR_GRUPO patrones por grupo de largo
+constexpr size_t TAMANO_CALIBRACION = 8 << 20;
+constexpr size_t PATRONES_POR_GRUPO = 8;
+constexpr int REPETICIONES = 3;
+constexpr size_t LARGO_CALIBRACION[CANT_GRUPOS] = {3, 6, 12, 24, 48, 96};
+
+// Patrones muy periódicos (período de a lo más la mitad del largo) pueden llevar a Horspool a O(n * m)
+constexpr size_t LARGO_MINIMO_PERIODICO = 9;
+
+// Modelo por defecto, medido con "calibrar" sobre un corpus de texto en un procesador con AVX2.
+// Columnas: a y b de cada grupo de largo (ns por byte = a + b * rasgo), con a >= 0 (ver calibrar)
+static const map<string, array<pair<double, double>, CANT_GRUPOS>> MODELO_POR_DEFECTO = {
+    {"Boyer-Moore", {{{3.06, 0.00}, {0.00, 8.89}, {0.00, 9.62}, {0.00, 8.92}, {0.00, 8.58}, {0.14, 4.58}}}},
+    {"Horspool",    {{{2.35, 0.00}, {0.00, 6.50}, {0.00, 6.68}, {0.00, 5.78}, {0.00, 6.69}, {0.07, 4.94}}}},
+    {"KMP",         {{{2.09, 0.00}, {2.27, 0.00}, {2.45, 0.00}, {2.12, 0.00}, {2.65, 0.00}, {1.97, 0.00}}}},
+    {"KMP-DFA",     {{{2.90, 0.00}, {2.78, 0.00}, {2.88, 0.00}, {2.75, 0.00}, {2.84, 0.00}, {2.80, 0.00}}}},
+    {"Robin-Karp",  {{{5.95, 0.00}, {5.71, 0.00}, {5.70, 0.00}, {5.64, 0.00}, {5.46, 0.00}, {5.64, 0.00}}}},
+    {"SIMD",        {{{0.25, 29.15}, {0.17, 21.15}, {0.10, 18.44}, {0.07, 21.58}, {0.08, 20.31}, {0.08, 20.16}}}},
+    {"Shift-Or",    {{{1.41, 0.00}, {1.33, 0.00}, {1.26, 0.00}, {1.24, 0.00}, {0.91, 0.00}, {3.39, 0.00}}}},
+    {"BNDM",        {{{0.00, 4.97}, {0.00, 8.05}, {0.67, 4.38}, {0.73, 0.00}, {0.45, 0.00}, {0.27, 1.75}}}},
+};
+constexpr double NS_AHO_CORASICK_POR_DEFECTO = 18.82;
+
+const array<string, CANT_GRUPOS> NOMBRES_GRUPOS = {"1-4", "5-8", "9-16", "17-32", "33-64", "65+"};
+
+size_t grupo_largo(size_t m) {
+    static const size_t limites[] = {4, 8, 16, 32, 64};
+    size_t g = 0;
+    while (g < CANT_GRUPOS - 1 && m > limites[g]) g++;
+    return g;
+}
+
+Planificador::Planificador() {
+    frecuencia.fill(1.0 / 256); // Sin muestrear se supone una distribución uniforme
+    for (const auto &[algoritmo, grupos] : MODELO_POR_DEFECTO) {
+        for (size_t g = 0; g < CANT_GRUPOS; g++) modelo[algoritmo][g] = {grupos[g].first, grupos[g].second};
+    }
+    ns_aho_corasick = NS_AHO_CORASICK_POR_DEFECTO;
+}
+
+// Formato: una línea "<algoritmo> <grupo> <a> <b>" por algoritmo y grupo, y "Aho-Corasick <ns por byte>".
+// Las líneas que empiezan con '#' son comentarios.
+bool Planificador::cargarModelo(const string &ruta) {
+
+    ifstream file(ruta);
+    if (!file.is_open()) return false;
+
+    string linea;
+    while (getline(file, linea)) {
+        if (linea.empty() || linea[0] == '#') continue;
+        istringstream campos(linea);
+        string algoritmo;
+        campos >> algoritmo;
+        if (algoritmo == "Aho-Corasick") {
+            campos >> ns_aho_corasick;
+            continue;
+        }
+        size_t g;
+        Coeficientes c;
+        if (!(campos >> g >> c.a >> c.b) || g >= CANT_GRUPOS || !esMotor(algoritmo)) {
+            cerr << "Línea inválida en el modelo de costos " << ruta << ": " << linea << endl;
+            return false;
+        }
+        modelo[algoritmo][g] = c;
+    }
+    return true;
+}
+
+bool Planificador::guardarModelo(const string &ruta) const {
+
+    ofstream file(ruta);
+    if (!file.is_open()) {
+        cerr << "Error al escribir el modelo de costos: " << ruta << endl;
+        return false;
+    }
+    file << "# Modelo de costos de detectar_patrones (ns por byte = a + b * rasgo)\n";
+    file << "# algoritmo grupo a b (grupos de largo: 1-4, 5-8, 9-16, 17-32, 33-64, 65+)\n";
+    for (const auto &[algoritmo, grupos] : modelo) {
+        for (size_t g = 0; g < CANT_GRUPOS; g++) {
+            file << algoritmo << " " << g << " " << grupos[g].a << " " << grupos[g].b << "\n";
+        }
+    }
+    file << "Aho-Corasick " << ns_aho_corasick << "\n";
+    return true;
+}
+
+void Planificador::muestrear(string_view texto) {
+
+    array<uint64_t, 256> cuenta{};
+    auto contar = [&cuenta](string_view bloque) {
+        for (unsigned char c : bloque) cuenta[c]++;
+    };
+    if (texto.size() <= BLOQUES_MUESTRA * LARGO_BLOQUE) {
+        contar(texto);
+    } else {
+        size_t paso = texto.size() / BLOQUES_MUESTRA;
+        for (size_t b = 0; b < BLOQUES_MUESTRA; b++) contar(texto.substr(b * paso, LARGO_BLOQUE));
+    }
+
+    // Se suma medio a cada byte para que los bytes que no aparecen en la muestra no tengan frecuencia 0
+    double total = 0;
+    for (uint64_t c : cuenta) total += c + 0.5;
+    for (size_t c = 0; c < 256; c++) frecuencia[c] = (cuenta[c] + 0.5) / total;
+}
+
+void Planificador::muestrearArchivo(const string &ruta) {
+    string muestra(1 << 20, '\0');
+    ifstream file(ruta, ios::binary);
+    file.read(&muestra[0], muestra.size());
+    muestra.resize(file.gcount());
+    muestrear(muestra);
+}
+
+RasgosPatron Planificador::rasgos(string_view patron) const {
+
+    RasgosPatron r;
+    size_t m = patron.size();
+    r.largo = m;
+    if (m == 0) return r;
+
+    // Borde más largo con la función de prefijos: el período mínimo es m - borde
+    vector<size_t> borde(m, 0);
+    for (size_t i = 1, k = 0; i < m; i++) {
+        while (k > 0 && patron[i] != patron[k]) k = borde[k - 1];
+        if (patron[i] == patron[k]) k++;
+        borde[i] = k;
+    }
+    r.periodo = m - borde[m - 1];
+
+    // Salto de Horspool para cada byte del texto alineado con el último byte del patrón
+    array<size_t, 256> salto;
+    salto.fill(m);
+    for (size_t i = 0; i + 1 < m; i++) salto[(unsigned char)patron[i]] = m - 1 - i;
+    r.salto_esperado = 0;
+    for (size_t c = 0; c < 256; c++) r.salto_esperado += frecuencia[c] * salto[c];
+    r.salto_esperado = max(1.0, r.salto_esperado);
+
+    r.tasa_candidatos = frecuencia[(unsigned char)patron[0]];
+    if (m > 1) r.tasa_candidatos *= frecuencia[(unsigned char)patron[m - 1]];
+    return r;
+}
+
+double Planificador::rasgo(const string &algoritmo, const RasgosPatron &r) const {
+    if (algoritmo == "Boyer-Moore" || algoritmo == "Horspool" || algoritmo == "BNDM") return 1.0 / r.salto_esperado;
+    if (algoritmo == "SIMD") return r.tasa_candidatos;
+    return 0;
+}
+
+double Planificador::costo(const string &algoritmo, const RasgosPatron &r, uint64_t largo_texto) const {
+    auto it = modelo.find(algoritmo);
+    if (it == modelo.end()) return HUGE_VAL;
+    const Coeficientes &c = it->second[grupo_largo(r.largo)];
+    return max(0.01, c.a + c.b * rasgo(algoritmo, r)) * largo_texto;
+}
+
+string Planificador::elegir(string_view patron, uint64_t largo_texto, const vector<string> &permitidos) const {
+
+    RasgosPatron r = rasgos(patron);
+    string mejor;
+    double mejor_costo = HUGE_VAL;
+    for (const string &algoritmo : permitidos) {
+        // Horspool no tiene la regla de Galil: se descarta con patrones largos y muy periódicos
+        if (algoritmo == "Horspool" && r.largo >= LARGO_MINIMO_PERIODICO && 2 * r.periodo <= r.largo) continue;
+        double c = costo(algoritmo, r, largo_texto);
+        if (c < mejor_costo) mejor = algoritmo, mejor_costo = c;
+    }
+    return mejor;
+}
+
+bool Planificador::preferirAhoCorasick(const vector<string> &patrones, uint64_t largo_texto) const {
+
+    double por_patron = 0;
+    for (const string &patron : patrones) {
+        RasgosPatron r = rasgos(patron);
+        por_patron += costo(elegir(patron, largo_texto), r, largo_texto);
+    }
+    return ns_aho_corasick * largo_texto < por_patron;
+}
+
+// Tiempo mínimo (ns) de varias ejecuciones de 'buscar'
+template <class Funcion>
+static double medir(Funcion buscar) {
+    double minimo = HUGE_VAL;
+    for (int r = 0; r < REPETICIONES; r++) {
+        auto inicio = chrono::steady_clock::now();
+        buscar();
+        auto fin = chrono::steady_clock::now();
+        minimo = min(minimo, (double)chrono::duration_cast<chrono::nanoseconds>(fin - inicio).count());
+    }
+    return minimo;
+}
+
+void Planificador::calibrar(string_view texto) {
+
+    texto = texto.substr(0, TAMANO_CALIBRACION);
+    muestrear(texto);
+    double n = max<size_t>(1, texto.size());
+
+    // Patrones sacados del mismo texto, con una semilla fija para que la calibración sea repetible
+    mt19937_64 rng(12345);
+    vector<vector<string>> patrones(CANT_GRUPOS);
+    for (size_t g = 0; g < CANT_GRUPOS; g++) {
+        size_t m = LARGO_CALIBRACION[g];
+        if (texto.size() < m) continue;
+        uniform_int_distribution<size_t> inicio(0, texto.size() - m);
+        for (size_t i = 0; i < PATRONES_POR_GRUPO; i++) patrones[g].push_back(string(texto.substr(inicio(rng), m)));
+    }
+
+    for (const string &algoritmo : MOTORES) {
+        for (size_t g = 0; g < CANT_GRUPOS; g++) {
+            if (patrones[g].empty()) continue;
+
+            // Mínimos cuadrados de los ns por byte de cada patrón contra su rasgo
+            vector<double> x, y;
+            for (const string &patron : patrones[g]) {
+                Buscador buscador = crearBuscador(algoritmo, patron);
+                x.push_back(rasgo(algoritmo, rasgos(patron)));
+                y.push_back(medir([&]() { return buscador.contar(texto); }) / n);
+            }
+            double media_x = 0, media_y = 0;
+            for (size_t i = 0; i < x.size(); i++) media_x += x[i] / x.size(), media_y += y[i] / y.size();
+            double sxx = 0, sxy = 0;
+            for (size_t i = 0; i < x.size(); i++) {
+                sxx += (x[i] - media_x) * (x[i] - media_x);
+                sxy += (x[i] - media_x) * (y[i] - media_y);
+            }
+
+            // Si el rasgo no varía o la pendiente sale negativa (ruido), el costo se toma como constante.
+            // El costo fijo por byte no puede ser negativo: si la recta lo da negativo, se ajusta una recta por
+            // el origen (a = 0). Si no, costo() lo recortaría a casi 0 con patrones de rasgo chico y el
+            // planificador preferiría el algoritmo por un defecto del ajuste y no por ser más rápido.
+            Coeficientes c;
+            c.b = sxx > 1e-12 ? max(0.0, sxy / sxx) : 0;
+            c.a = media_y - c.b * media_x;
+            if (c.a < 0) {
+                double sxx_origen = 0, sxy_origen = 0;
+                for (size_t i = 0; i < x.size(); i++) sxx_origen += x[i] * x[i], sxy_origen += x[i] * y[i];
+                c.a = 0;
+                c.b = sxx_origen > 1e-12 ? max(0.0, sxy_origen / sxx_origen) : 0;
+            }
+            modelo[algoritmo][g] = c;
+        }
+    }
+
+    // Aho-Corasick con patrones de todos los largos
+    vector<string> todos;
+    for (const auto &grupo : patrones) todos.insert(todos.end(), grupo.begin(), grupo.end());
+    if (!todos.empty()) ns_aho_corasick = medir([&]() { return ahoCorasick(texto, todos); }) / n;
+}
+
+int calibrar_modelo(const string &ruta) {
+
+    Corpus corpus;
+    vector<uint64_t> pos_final_archivos;
+    bool leido = fs::is_directory(ruta) ? corpus.cargarCarpeta(ruta, &pos_final_archivos) : corpus.cargarArchivo(ruta);
+    if (!leido) {
+        cerr << "Error al leer el archivo o carpeta." << endl;
+        return 1;
+    }
+
+    Planificador planificador;
+    startTimer();
+    planificador.calibrar(corpus.texto());
+    cout << "\nTiempo de calibración: ";
+    stopTimer();
+
+    if (!planificador.guardarModelo(ARCHIVO_MODELO)) return 1;
+    cout << "Modelo de costos: " << ARCHIVO_MODELO << endl;
+    ifstream modelo(ARCHIVO_MODELO);
+    cout << modelo.rdbuf();
+    return 0;
+}
@@ -0,0 +1,76 @@
+#ifndef PLANIFICADOR_HPP
+#define PLANIFICADOR_HPP
+
+#include <array>
+#include <cstdint>
+#include <map>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "motores.hpp"
+using namespace std;
+
+// Archivo donde "calibrar" guarda el modelo de costos y desde donde lo carga el algoritmo "Auto"
+extern const string ARCHIVO_MODELO;
+
+// Grupos de largo de patrón del modelo: [1,4], [5,8], [9,16], [17,32], [33,64], [65,...)
+constexpr size_t CANT_GRUPOS = 6;
+extern const array<string, CANT_GRUPOS> NOMBRES_GRUPOS; // "1-4", "5-8", ... (también los usa el benchmark)
+size_t grupo_largo(size_t m);
+
+// Rasgos de un patrón frente a la distribución de bytes del corpus
+struct RasgosPatron {
+    size_t largo = 0;
+    size_t periodo = 0;           // Período mínimo (largo menos el borde más largo)
+    double salto_esperado = 1;    // Salto promedio de Horspool según la frecuencia de cada byte en el corpus
+    double tasa_candidatos = 0;   // Probabilidad de que el primer y el último byte coincidan (filtro de SIMD)
+};
+
+// Elige el algoritmo más rápido para cada patrón según un modelo de costos lineal por algoritmo
+// y grupo de largo: ns por byte = a + b * x, donde x es el rasgo del patrón que más influye en ese
+// algoritmo (1 / salto esperado en Boyer-Moore, Horspool y BNDM, tasa de candidatos en SIMD, nada en los demás).
+class Planificador {
+public:
+    Planificador();
+
+    // Carga el modelo guardado por "calibrar". Si no existe se sigue con el modelo por defecto.
+    bool cargarModelo(const string &ruta);
+    bool guardarModelo(const string &ruta) const;
+
+    // Calcula la frecuencia de cada byte a partir de bloques repartidos por el texto
+    void muestrear(string_view texto);
+
+    // Igual que muestrear, con el primer MiB de un archivo (para los modos que no cargan el corpus completo)
+    void muestrearArchivo(const string &ruta);
+
+    RasgosPatron rasgos(string_view patron) const;
+
+    // Costo estimado (ns) de buscar el patrón en 'largo_texto' bytes con el algoritmo
+    double costo(const string &algoritmo, const RasgosPatron &r, uint64_t largo_texto) const;
+
+    // Algoritmo de menor costo estimado entre los permitidos
+    string elegir(string_view patron, uint64_t largo_texto, const vector<string> &permitidos = MOTORES) const;
+
+    // Indica si una sola pasada de Aho-Corasick cuesta menos que buscar cada patrón con su mejor algoritmo
+    bool preferirAhoCorasick(const vector<string> &patrones, uint64_t largo_texto) const;
+
+    // Microbenchmark de los algoritmos sobre el texto que ajusta el modelo de esta máquina
+    void calibrar(string_view texto);
+
+private:
+    struct Coeficientes {
+        double a = 0; // ns por byte fijos
+        double b = 0; // ns por byte por unidad del rasgo
+    };
+
+    double rasgo(const string &algoritmo, const RasgosPatron &r) const;
+
+    array<double, 256> frecuencia;
+    map<string, array<Coeficientes, CANT_GRUPOS>> modelo;
+    double ns_aho_corasick = 0; // ns por byte de Aho-Corasick (casi no depende de los patrones)
+};
+
+// Comando "calibrar": mide los algoritmos sobre la carpeta o el archivo y guarda el modelo en ARCHIVO_MODELO
+int calibrar_modelo(const string &ruta);
+
+#endif
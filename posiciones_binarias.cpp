@@ -0,0 +1,202 @@
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+#include "posiciones_binarias.hpp"
+#include "utils.hpp"
+
+using namespace std;
+
+// Identifica el formato del archivo de posiciones
+static const char MAGIA[8] = {'P', 'A', 'T', 'P', 'O', 'S', 'V', '2'};
+
+static void escribir_varint(string &buffer, uint64_t valor) {
+    while (valor >= 0x80) {
+        buffer.push_back(static_cast<char>(valor | 0x80));
+        valor >>= 7;
+    }
+    buffer.push_back(static_cast<char>(valor));
+}
+
+// Avanza 'p' sobre un varint. Devuelve false si el varint está cortado o es demasiado largo.
+static inline bool leer_varint(const char *&p, const char *fin, uint64_t *valor) {
+    uint64_t v = 0;
+    for (int desplazamiento = 0; p < fin && desplazamiento < 64; desplazamiento += 7) {
+        uint8_t byte = static_cast<uint8_t>(*p++);
+        v |= uint64_t(byte & 0x7f) << desplazamiento;
+        if (!(byte & 0x80)) {
+            *valor = v;
+            return true;
+        }
+    }
+    return false;
+}
+
+static void escribir_texto(string &buffer, const string &texto) {
+    escribir_varint(buffer, texto.size());
+    buffer += texto;
+}
+
+static bool leer_texto(const char *&p, const char *fin, string *texto) {
+    uint64_t largo;
+    if (!leer_varint(p, fin, &largo) || largo > uint64_t(fin - p)) return false;
+    texto->assign(p, largo);
+    p += largo;
+    return true;
+}
+
+uint64_t guardar_posiciones(const string &ruta, const vector<string> &patrones, const vector<string> &nombres,
+                            const vector<uint64_t> &inicios, const vector<uint64_t> &fines,
+                            const vector<vector<uint64_t>> &posiciones) {
+
+    ofstream out(ruta, ios::binary);
+    if (!out.is_open()) {
+        cerr << "Error al crear el archivo de posiciones: " << ruta << endl;
+        return 0;
+    }
+    out.write(MAGIA, sizeof(MAGIA));
+    uint64_t escritos = sizeof(MAGIA);
+
+    string indice;
+    escribir_varint(indice, patrones.size());
+    for (const string &patron : patrones) escribir_texto(indice, patron);
+    escribir_varint(indice, nombres.size());
+    for (const string &nombre : nombres) escribir_texto(indice, nombre);
+
+    // Cada bloque se codifica en un buffer que se reutiliza y se escribe apenas termina; en el índice
+    // solo queda su cantidad de posiciones y su largo
+    string bloque;
+    for (size_t p = 0; p < patrones.size(); p++) {
+        const vector<uint64_t> *encontradas = &posiciones[p];
+        vector<uint64_t> ordenadas;
+        if (!is_sorted(encontradas->begin(), encontradas->end())) {
+            ordenadas = *encontradas;
+            sort(ordenadas.begin(), ordenadas.end());
+            encontradas = &ordenadas;
+        }
+
+        size_t j = 0;
+        for (size_t a = 0; a < nombres.size(); a++) {
+            bloque.clear();
+            uint64_t cantidad = 0, anterior = 0;
+            for (; j < encontradas->size() && (*encontradas)[j] < fines[a]; j++) {
+                if ((*encontradas)[j] < inicios[a]) continue;
+                uint64_t posicion = (*encontradas)[j] - inicios[a];
+                escribir_varint(bloque, posicion - anterior);
+                anterior = posicion;
+                cantidad++;
+            }
+            out.write(bloque.data(), bloque.size());
+            escritos += bloque.size();
+            escribir_varint(indice, cantidad);
+            escribir_varint(indice, bloque.size());
+        }
+    }
+
+    uint64_t inicio_indice = escritos;
+    char final_indice[8];
+    for (int i = 0; i < 8; i++) final_indice[i] = static_cast<char>(inicio_indice >> (8 * i));
+    out.write(indice.data(), indice.size());
+    out.write(final_indice, sizeof(final_indice));
+    out.close();
+    if (!out) {
+        cerr << "Error al escribir el archivo de posiciones: " << ruta << endl;
+        return 0;
+    }
+    return escritos + indice.size() + sizeof(final_indice);
+}
+
+bool leer_posiciones(const string &ruta, PosicionesGuardadas *salida) {
+
+    // El archivo se mapea en memoria igual que un texto de búsqueda (-a)
+    Corpus archivo;
+    if (!archivo.cargarArchivo(ruta)) return false;
+    const char *datos = archivo.texto().data();
+    uint64_t largo = archivo.texto().size();
+
+    auto danado = [&]() {
+        cerr << "Archivo de posiciones dañado o incompleto: " << ruta << endl;
+        return false;
+    };
+
+    if (largo < sizeof(MAGIA) || !equal(datos, datos + sizeof(MAGIA), MAGIA)) {
+        cerr << "Archivo de posiciones con formato desconocido: " << ruta << endl;
+        return false;
+    }
+    if (largo < sizeof(MAGIA) + 8) return danado();
+
+    // El índice va entre los bloques y los 8 bytes finales con su posición
+    uint64_t inicio_indice = 0;
+    for (int i = 0; i < 8; i++) inicio_indice |= uint64_t(static_cast<uint8_t>(datos[largo - 8 + i])) << (8 * i);
+    if (inicio_indice < sizeof(MAGIA) || inicio_indice > largo - 8) return danado();
+    const char *p = datos + inicio_indice;
+    const char *fin = datos + largo - 8;
+
+    // Cada patrón o nombre ocupa al menos un byte del índice, lo que acota las cantidades de un archivo dañado
+    uint64_t cant_patrones, cant_archivos;
+    if (!leer_varint(p, fin, &cant_patrones) || cant_patrones > uint64_t(fin - p)) return danado();
+    salida->patrones.assign(cant_patrones, "");
+    for (string &patron : salida->patrones) {
+        if (!leer_texto(p, fin, &patron)) return danado();
+    }
+    if (!leer_varint(p, fin, &cant_archivos) || cant_archivos > uint64_t(fin - p)) return danado();
+    salida->nombres.assign(cant_archivos, "");
+    for (string &nombre : salida->nombres) {
+        if (!leer_texto(p, fin, &nombre)) return danado();
+    }
+
+    // Cada par (patrón, archivo) ocupa al menos 2 bytes del índice: se valida antes de reservar nada,
+    // así un archivo dañado no puede pedir una reserva enorme ni desbordar el producto
+    if (cant_archivos > 0 && cant_patrones > uint64_t(fin - p) / 2 / cant_archivos) return danado();
+    uint64_t pares = cant_patrones * cant_archivos;
+    vector<uint64_t> cantidades(pares), largos(pares);
+    uint64_t total_bloques = 0;
+    for (size_t i = 0; i < pares; i++) {
+        if (!leer_varint(p, fin, &cantidades[i]) || !leer_varint(p, fin, &largos[i])) return danado();
+        // Cada posición ocupa al menos un byte del bloque, y los bloques llenan el espacio antes del índice
+        if (cantidades[i] > largos[i] || largos[i] > inicio_indice - sizeof(MAGIA) - total_bloques) return danado();
+        total_bloques += largos[i];
+    }
+    if (p != fin || total_bloques != inicio_indice - sizeof(MAGIA)) return danado();
+
+    p = datos + sizeof(MAGIA);
+    salida->posiciones.assign(cant_patrones, vector<vector<uint64_t>>(cant_archivos));
+    for (size_t i = 0; i < pares; i++) {
+        const char *fin_bloque = p + largos[i];
+        vector<uint64_t> &bloque = salida->posiciones[i / cant_archivos][i % cant_archivos];
+        bloque.resize(cantidades[i]);
+        uint64_t posicion = 0;
+        for (uint64_t &destino : bloque) {
+            // La mayoría de las diferencias cabe en un byte
+            uint64_t diferencia;
+            if (p < fin_bloque && !(*p & 0x80)) diferencia = static_cast<uint8_t>(*p++);
+            else if (!leer_varint(p, fin_bloque, &diferencia)) return danado();
+            posicion += diferencia;
+            destino = posicion;
+        }
+        if (p != fin_bloque) return danado();
+    }
+    return true;
+}
+
+int imprimir_posiciones(const string &ruta) {
+
+    PosicionesGuardadas guardadas;
+    startTimer();
+    if (!leer_posiciones(ruta, &guardadas)) return 1;
+    cout << "\nTiempo de lectura: ";
+    stopTimer();
+
+    cout << "\nPatron, Texto" << endl;
+    for (size_t p = 0; p < guardadas.patrones.size(); p++) cout << p + 1 << ",  " << guardadas.patrones[p] << "\n";
+
+    cout << "\nPatron, Archivo, Posicion" << "\n";
+    for (size_t p = 0; p < guardadas.patrones.size(); p++) {
+        for (size_t a = 0; a < guardadas.nombres.size(); a++) {
+            for (uint64_t posicion : guardadas.posiciones[p][a]) {
+                cout << p + 1 << ",  " << guardadas.nombres[a] << ",  " << posicion << "\n";
+            }
+        }
+    }
+    cout << flush;
+    return 0;
+}
@@ -0,0 +1,41 @@
+#ifndef POSICIONES_BINARIAS_HPP
+#define POSICIONES_BINARIAS_HPP
+
+#include <cstdint>
+#include <string>
+#include <vector>
+using namespace std;
+
+// Archivo binario compacto con las posiciones encontradas (-o), para exportarlas a otras herramientas.
+// Salvo el último campo, todos los números se guardan como varint (7 bits por byte, el bit alto indica que
+// sigue otro byte):
+//   "PATPOSV2"
+//   los bloques, por patrón y por archivo: las posiciones dentro del archivo (desde 0) como diferencias con la anterior
+//   el índice: cantidad de patrones, y cada patrón como <largo><bytes>; cantidad de archivos, y cada nombre
+//   como <largo><bytes>; y por patrón y por archivo, <cantidad de posiciones><bytes del bloque>
+//   la posición del índice en el archivo, como uint64_t little-endian de 8 bytes
+// Las posiciones de un bloque están ordenadas, así que las diferencias son chicas y la mayoría ocupa 1 o 2 bytes
+// en vez de los 8 de un uint64_t o los ~10 de una línea de texto. Cada bloque se escribe apenas se codifica y el
+// índice va al final, así que al escribir no se arma el archivo completo en memoria. El índice da la ubicación
+// de cada bloque, por lo que se puede leer un solo par (patrón, archivo) sin decodificar el resto.
+
+struct PosicionesGuardadas {
+    vector<string> patrones;
+    vector<string> nombres;                        // Nombres de los archivos
+    vector<vector<vector<uint64_t>>> posiciones;   // posiciones[p][a] = posiciones del patrón p en el archivo a
+};
+
+// Guarda las posiciones de cada patrón, dadas sobre el texto completo, separadas por archivo. El archivo a ocupa
+// [inicios[a], fines[a]) del texto; las posiciones fuera de todos los archivos (en un separador "$") se descartan.
+// Devuelve la cantidad de bytes escritos (0 si hubo un error).
+uint64_t guardar_posiciones(const string &ruta, const vector<string> &patrones, const vector<string> &nombres,
+                            const vector<uint64_t> &inicios, const vector<uint64_t> &fines,
+                            const vector<vector<uint64_t>> &posiciones);
+
+// Lee un archivo escrito por guardar_posiciones
+bool leer_posiciones(const string &ruta, PosicionesGuardadas *salida);
+
+// Comando "leer": imprime el contenido del archivo como CSV (Patron, Archivo, Posicion)
+int imprimir_posiciones(const string &ruta);
+
+#endif
@@ -0,0 +1,181 @@
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <iostream>
+#include <sstream>
+#include <thread>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#include "servidor.hpp"
+#include "utils.hpp"
+#include "motores.hpp"
+#include "planificador.hpp"
+
+using namespace std;
+
+// Estado compartido por todas las consultas. Después de cargarlo solo se lee, así que no necesita candados.
+struct Contexto {
+    Corpus corpus;
+    vector<uint64_t> pos_final_archivos;
+    Planificador planificador;  // Para las consultas con "Auto"
+    atomic<uint64_t> consultas{0};
+};
+
+// Responde una consulta "<algoritmo> <patrón>". Devuelve false si la línea pide cerrar la conexión.
+static bool responder(Contexto &contexto, const string &linea, ostream &salida) {
+
+    if (linea == "salir") return false;
+
+    auto inicio = chrono::steady_clock::now();
+    uint64_t numero = ++contexto.consultas;
+
+    size_t espacio = linea.find(' ');
+    string algoritmo = linea.substr(0, espacio);
+    string patron = espacio == string::npos ? "" : linea.substr(espacio + 1);
+    string_view texto = contexto.corpus.texto();
+
+    if (algoritmo == "Auto") algoritmo = contexto.planificador.elegir(patron, texto.size());
+    if (!esMotor(algoritmo)) {
+        salida << "ERROR Algoritmo no reconocido: " << algoritmo << "\nFIN" << endl;
+        return true;
+    }
+    if (patron.empty()) {
+        salida << "ERROR Falta el patrón\nFIN" << endl;
+        return true;
+    }
+
+    // Cada coincidencia suma al conteo de su archivo, sin guardar posiciones
+    const vector<uint64_t> &finales = contexto.pos_final_archivos;
+    vector<uint64_t> conteos(finales.size(), 0);
+    uint64_t total = 0;
+    crearBuscador(algoritmo, patron).cada(texto, [&](uint64_t pos) {
+        size_t archivo = archivo_de_posicion(pos, finales);
+        if (archivo < conteos.size()) conteos[archivo]++;
+        total++;
+        return true;
+    });
+    long long ns = chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now() - inicio).count();
+
+    imprimir_conteos(contexto.corpus.nombres(), conteos, salida);
+    salida << "Total: " << total << "\nAlgoritmo: " << algoritmo << "\nTiempo de consulta (ns): " << ns << "\nFIN" << endl;
+    cerr << "Consulta " << numero << ": " << algoritmo << " (" << patron.size() << " bytes), "
+         << total << " coincidencias, " << ns << " ns" << endl;
+    return true;
+}
+
+// Escribe todo el buffer en el socket aunque send lo acepte por partes.
+// MSG_NOSIGNAL evita que un cliente que se desconecta termine el servidor con SIGPIPE.
+static bool escribir_todo(int fd, const string &datos) {
+    size_t enviado = 0;
+    while (enviado < datos.size()) {
+        ssize_t n = send(fd, datos.data() + enviado, datos.size() - enviado, MSG_NOSIGNAL);
+        if (n <= 0) return false;
+        enviado += n;
+    }
+    return true;
+}
+
+// Atiende a un cliente del socket: lee líneas y responde cada una hasta que cierre la conexión o pida "salir"
+static void atender_cliente(Contexto &contexto, int fd) {
+
+    string pendiente;
+    char buffer[4096];
+    bool seguir = true;
+    while (seguir) {
+        ssize_t n = read(fd, buffer, sizeof(buffer));
+        if (n <= 0) break;
+        pendiente.append(buffer, n);
+
+        size_t fin;
+        while (seguir && (fin = pendiente.find('\n')) != string::npos) {
+            string linea = pendiente.substr(0, fin);
+            pendiente.erase(0, fin + 1);
+            if (!linea.empty() && linea.back() == '\r') linea.pop_back();
+            if (linea.empty()) continue;
+
+            ostringstream respuesta;
+            seguir = responder(contexto, linea, respuesta);
+            if (!escribir_todo(fd, respuesta.str())) seguir = false;
+        }
+    }
+    close(fd);
+}
+
+static int escuchar_socket(Contexto &contexto, const string &ruta_socket) {
+
+    sockaddr_un direccion{};
+    if (ruta_socket.size() >= sizeof(direccion.sun_path)) {
+        cerr << "Ruta de socket demasiado larga: " << ruta_socket << endl;
+        return 1;
+    }
+    direccion.sun_family = AF_UNIX;
+    ruta_socket.copy(direccion.sun_path, ruta_socket.size());
+
+    int servidor_fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (servidor_fd < 0) {
+        cerr << "Error al crear el socket." << endl;
+        return 1;
+    }
+    unlink(ruta_socket.c_str()); // Un socket viejo de una ejecución anterior impediría el bind
+    if (bind(servidor_fd, reinterpret_cast<sockaddr *>(&direccion), sizeof(direccion)) < 0 || listen(servidor_fd, 64) < 0) {
+        cerr << "Error al escuchar en el socket: " << ruta_socket << endl;
+        close(servidor_fd);
+        return 1;
+    }
+    cerr << "Escuchando en " << ruta_socket << endl;
+
+    // Un hilo por cliente; el contexto vive hasta que termina el proceso
+    bool sin_recursos = false; // Para avisar una sola vez mientras dura la falta de descriptores o memoria
+    while (true) {
+        int cliente = accept(servidor_fd, nullptr, nullptr);
+        if (cliente >= 0) {
+            sin_recursos = false;
+            thread(atender_cliente, ref(contexto), cliente).detach();
+            continue;
+        }
+        // Una señal o un cliente que cerró la conexión antes de aceptarla: se reintenta enseguida
+        if (errno == EINTR || errno == ECONNABORTED) continue;
+        // Sin descriptores o sin memoria el error se repite hasta que terminen otros clientes; reintentar
+        // enseguida dejaría el hilo girando al 100% de CPU, así que se espera antes de volver a intentar
+        if (errno == EMFILE || errno == ENFILE || errno == ENOBUFS || errno == ENOMEM) {
+            if (!sin_recursos) cerr << "Error al aceptar un cliente (" << strerror(errno) << "), se reintenta cada 100 ms." << endl;
+            sin_recursos = true;
+            this_thread::sleep_for(chrono::milliseconds(100));
+            continue;
+        }
+        cerr << "Error al aceptar un cliente (" << strerror(errno) << "), el servidor se detiene." << endl;
+        close(servidor_fd);
+        unlink(ruta_socket.c_str());
+        return 1;
+    }
+}
+
+int servidor(const string &carpeta, int cantidadArchivos, const string &ruta_socket) {
+
+    static Contexto contexto; // Compartido con los hilos de los clientes, que pueden seguir vivos al salir
+    auto inicio = chrono::steady_clock::now();
+    if (!contexto.corpus.cargarCarpeta(carpeta, &contexto.pos_final_archivos, cantidadArchivos)) {
+        cerr << "Error al leer el archivo o carpeta." << endl;
+        return 1;
+    }
+    contexto.planificador.cargarModelo(ARCHIVO_MODELO);
+    contexto.planificador.muestrear(contexto.corpus.texto());
+    long long ns = chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now() - inicio).count();
+    cerr << "Corpus cargado (" << contexto.corpus.texto().size() << " bytes, "
+         << contexto.corpus.nombres().size() << " archivos) en " << ns << " ns" << endl;
+
+    if (!ruta_socket.empty()) return escuchar_socket(contexto, ruta_socket);
+
+    // Entrada estándar: las consultas se responden una a una en la salida estándar.
+    // "LISTO" separa los mensajes de la carga de las respuestas.
+    cout << "LISTO" << endl;
+    string linea;
+    while (getline(cin, linea)) {
+        if (!linea.empty() && linea.back() == '\r') linea.pop_back();
+        if (linea.empty()) continue;
+        if (!responder(contexto, linea, cout)) break;
+    }
+    return 0;
+}
@@ -0,0 +1,16 @@
+#ifndef SERVIDOR_HPP
+#define SERVIDOR_HPP
+
+#include <string>
+using namespace std;
+
+// Modo servidor: carga la carpeta una sola vez y responde consultas sin volver a leer los archivos.
+// Protocolo por líneas (en la entrada estándar o en un socket Unix):
+//   consulta:  "<algoritmo> <patrón>"   (el patrón es el resto de la línea)
+//   respuesta: las ocurrencias por archivo como en encuentros_por_archivo, el total y la latencia
+//              de la consulta, terminadas en una línea "FIN". Los errores responden "ERROR <mensaje>" y "FIN".
+//   "salir" cierra la conexión (o el servidor, si se usa la entrada estándar).
+// Con socket cada cliente se atiende en su propio hilo y todos comparten el corpus de solo lectura.
+int servidor(const string &carpeta, int cantidadArchivos, const string &ruta_socket);
+
+#endif
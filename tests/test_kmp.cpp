@@ -0,0 +1,74 @@
+// Prueba de regresión de KMP con patrones periódicos: compara KMPCompilado (con y sin mayúsculas) y KMPFlujo
+// con una búsqueda ingenua. Una tabla de fallos que vuelve al inicio en vez de seguir la cadena de bordes
+// pierde coincidencias en estos patrones (p. ej. "AaAAAaa" en "AaAAaAAAaa").
+#include <iostream>
+#include <string>
+#include <vector>
+#include "algoritmos/KMP.hpp"
+
+using namespace std;
+
+static vector<uint64_t> ingenua(const string &patron, const string &texto, bool ignorarMayusculas) {
+    string p = ignorarMayusculas ? plegar(patron) : patron, t = ignorarMayusculas ? plegar(texto) : texto;
+    vector<uint64_t> posiciones;
+    for (size_t i = 0; i + p.size() <= t.size(); i++) {
+        if (t.compare(i, p.size(), p) == 0) posiciones.push_back(i);
+    }
+    return posiciones;
+}
+
+static int fallas = 0;
+
+static void comparar(const string &nombre, const string &patron, const string &texto, const vector<uint64_t> &obtenidas,
+                     const vector<uint64_t> &esperadas) {
+    if (obtenidas == esperadas) return;
+    cerr << "FALLA " << nombre << ": patron \"" << patron << "\" en \"" << texto << "\", " << obtenidas.size()
+         << " coincidencias en vez de " << esperadas.size() << endl;
+    fallas++;
+}
+
+static void probar(const string &patron, const string &texto) {
+    for (bool ignorarMayusculas : {false, true}) {
+        vector<uint64_t> obtenidas;
+        SinkPosiciones sink{&obtenidas};
+        if (ignorarMayusculas) KMPCompilado<SinMayusculas>(patron).buscar(texto, sink);
+        else KMPCompilado<Exacto>(patron).buscar(texto, sink);
+        comparar(ignorarMayusculas ? "KMPCompilado -i" : "KMPCompilado", patron, texto, obtenidas,
+                 ingenua(patron, texto, ignorarMayusculas));
+
+        // En el flujo el texto llega de a un byte, para que las coincidencias crucen los bloques
+        vector<uint64_t> flujo;
+        KMPFlujo kmp(patron, ignorarMayusculas);
+        for (char c : texto) kmp.alimentar(string_view(&c, 1), [&](uint64_t posicion) { flujo.push_back(posicion); });
+        comparar(ignorarMayusculas ? "KMPFlujo -i" : "KMPFlujo", patron, texto, flujo, ingenua(patron, texto, ignorarMayusculas));
+    }
+}
+
+int main() {
+    probar("AaAAAaa", "AaAAaAAAaa");
+    probar("aabaaab", "aabaabaaab");
+    probar("abab", "abababab");
+    probar("aaa", "aaaaaa");
+
+    // Todos los patrones de hasta 7 bytes sobre {a, A} contra un texto pseudoaleatorio del mismo alfabeto
+    string texto;
+    uint32_t semilla = 12345;
+    for (int i = 0; i < 4096; i++) {
+        semilla = semilla * 1103515245 + 12345;
+        texto += (semilla >> 16) & 1 ? 'A' : 'a';
+    }
+    for (int largo = 1; largo <= 7; largo++) {
+        for (int bits = 0; bits < (1 << largo); bits++) {
+            string patron;
+            for (int i = 0; i < largo; i++) patron += bits >> i & 1 ? 'A' : 'a';
+            probar(patron, texto);
+        }
+    }
+
+    if (fallas > 0) {
+        cerr << fallas << " pruebas fallaron" << endl;
+        return 1;
+    }
+    cout << "KMP: todas las pruebas pasaron" << endl;
+    return 0;
+}
@@ -0,0 +1,192 @@
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include "tuberia.hpp"
+#include "utils.hpp"
+#include "algoritmos/comodines.hpp"
+#include "motores.hpp"
+#include "planificador.hpp"
+
+using namespace std;
+namespace fs = std::filesystem;
+using Reloj = chrono::steady_clock;
+
+// Hilos que leen archivos del disco
+constexpr int LECTORES = 2;
+// Buffers en la cola por cada buscador: con pocos buffers la memoria queda acotada aunque la carpeta sea enorme
+constexpr size_t BUFFERS_POR_BUSCADOR = 2;
+
+// Archivo leído completo, a la espera de un buscador
+struct ArchivoLeido {
+    size_t indice;   // Posición del archivo en la lista
+    string contenido;
+};
+
+// Cola de capacidad fija: 'poner' espera si está llena y 'sacar' espera si está vacía.
+// Después de 'cerrar', 'sacar' devuelve nullopt cuando ya no quedan elementos.
+template <class T>
+class ColaAcotada {
+public:
+    explicit ColaAcotada(size_t capacidad) : capacidad(capacidad) {}
+
+    void poner(T elemento) {
+        unique_lock<mutex> candado(m);
+        hay_espacio.wait(candado, [&] { return elementos.size() < capacidad; });
+        elementos.push_back(move(elemento));
+        hay_elementos.notify_one();
+    }
+
+    optional<T> sacar() {
+        unique_lock<mutex> candado(m);
+        hay_elementos.wait(candado, [&] { return !elementos.empty() || cerrada; });
+        if (elementos.empty()) return nullopt;
+        T elemento = move(elementos.front());
+        elementos.pop_front();
+        hay_espacio.notify_one();
+        return elemento;
+    }
+
+    void cerrar() {
+        lock_guard<mutex> candado(m);
+        cerrada = true;
+        hay_elementos.notify_all();
+    }
+
+private:
+    size_t capacidad;
+    deque<T> elementos;
+    bool cerrada = false;
+    mutex m;
+    condition_variable hay_espacio, hay_elementos;
+};
+
+static long long nanosegundos(Reloj::time_point inicio) {
+    return chrono::duration_cast<chrono::nanoseconds>(Reloj::now() - inicio).count();
+}
+
+int busqueda_recursiva(const string &carpeta, int cantidadArchivos, const string &algoritmo,
+                       const vector<string> &patrones, bool varios_patrones, int buscadores,
+                       bool ignorarMayusculas, bool comodines) {
+
+    if (!fs::is_directory(carpeta)) {
+        cerr << "La ruta especificada no es una carpeta: " << carpeta << endl;
+        return 1;
+    }
+    vector<string> archivos = listar_archivos(carpeta, cantidadArchivos, true);
+
+    // Un buscador por patrón, preparado una sola vez y compartido por todos los hilos
+    vector<Buscador> preparados;
+    Planificador planificador;
+    bool automatico = algoritmo == "Auto";
+    if (automatico) {
+        planificador.cargarModelo(ARCHIVO_MODELO);
+        if (!archivos.empty()) planificador.muestrearArchivo(archivos[0]);
+    }
+    uint64_t total_bytes = 0;
+    for (const string &archivo : archivos) {
+        error_code error;
+        uint64_t tam = fs::file_size(archivo, error); // Un archivo que no se puede medir se reporta al leerlo
+        if (!error) total_bytes += tam;
+    }
+    for (const string &patron : patrones) {
+        // Con comodines el planificador elige el algoritmo del factor literal
+        string buscado = comodines ? PatronComodin(patron).factor() : patron;
+        string elegido = automatico ? planificador.elegir(buscado.empty() ? patron : buscado, total_bytes) : algoritmo;
+        if (!esMotor(elegido)) {
+            cerr << "La búsqueda recursiva (-r) solo usa algoritmos de un patrón o Auto." << endl;
+            return 1;
+        }
+        preparados.push_back(crearBuscador(elegido, patron, nullptr, ignorarMayusculas, comodines));
+    }
+
+    buscadores = max(1, buscadores);
+    // Los buffers circulan entre las dos colas: los lectores toman uno libre, lo llenan y lo ponen en 'cola';
+    // los buscadores lo devuelven a 'libres' al terminar. Así cada buffer conserva su capacidad y solo se
+    // vuelve a reservar cuando llega un archivo más grande que los anteriores.
+    size_t cant_buffers = (BUFFERS_POR_BUSCADOR + 1) * buscadores;
+    ColaAcotada<ArchivoLeido> cola(cant_buffers);
+    ColaAcotada<string> libres(cant_buffers);
+    for (size_t i = 0; i < cant_buffers; i++) libres.poner(string());
+    atomic<size_t> siguiente(0);
+    atomic<long long> ns_lectura(0), ns_busqueda(0);
+    atomic<bool> error(false);
+
+    // Las ocurrencias de cada archivo se imprimen apenas se termina de buscar, en el orden de la lista: las de
+    // un archivo que termina antes que los anteriores esperan en 'pendientes' (solo los archivos en vuelo).
+    mutex m_salida;
+    map<size_t, vector<uint64_t>> pendientes;
+    size_t siguiente_impreso = 0;
+    auto imprimir = [&](size_t indice, vector<uint64_t> conteos) {
+        lock_guard<mutex> candado(m_salida);
+        pendientes.emplace(indice, move(conteos));
+        // Un archivo que no se pudo leer no tiene conteos: deja un vector vacío y no se imprime nada
+        for (auto it = pendientes.begin(); it != pendientes.end() && it->first == siguiente_impreso;
+             it = pendientes.erase(it), siguiente_impreso++) {
+            for (size_t p = 0; p < it->second.size(); p++) {
+                if (it->second[p] == 0) continue;
+                if (varios_patrones) cout << p + 1 << ",  ";
+                cout << fs::relative(archivos[it->first], carpeta).string() << ",  " << it->second[p] << '\n';
+            }
+        }
+    };
+
+    cout << "Archivo: " << carpeta << " (" << archivos.size() << " archivos, " << total_bytes << " bytes)" << endl;
+    cout << (varios_patrones ? "\nPatron, Archivo, Ocurrencias" : "\nArchivo, Ocurrencias") << endl;
+
+    auto inicio = Reloj::now();
+
+    // Lectores: toman el siguiente archivo libre y lo leen completo en un buffer de 'libres'
+    auto lector = [&]() {
+        for (size_t a = siguiente++; a < archivos.size(); a = siguiente++) {
+            auto t = Reloj::now();
+            // Sin excepciones: una excepción en el hilo lector terminaría el programa
+            ifstream file(archivos[a], ios::binary);
+            error_code error_tam;
+            uint64_t tam = fs::file_size(archivos[a], error_tam);
+            if (!file.is_open() || error_tam) {
+                cerr << "Error al abrir el archivo: " << archivos[a] << endl;
+                error = true;
+                imprimir(a, {});
+                continue;
+            }
+            ArchivoLeido leido{a, move(*libres.sacar())};
+            leido.contenido.resize(tam);
+            file.read(&leido.contenido[0], leido.contenido.size());
+            leido.contenido.resize(file.gcount()); // Si el archivo cambió de tamaño, se usa lo que realmente se leyó
+            ns_lectura += nanosegundos(t);
+            cola.poner(move(leido));
+        }
+    };
+
+    // Buscadores: cada archivo se busca con todos los patrones apenas sale de la cola
+    auto buscador = [&]() {
+        while (optional<ArchivoLeido> leido = cola.sacar()) {
+            auto t = Reloj::now();
+            vector<uint64_t> conteos(preparados.size());
+            for (size_t p = 0; p < preparados.size(); p++) conteos[p] = preparados[p].contar(leido->contenido);
+            ns_busqueda += nanosegundos(t);
+            libres.poner(move(leido->contenido));
+            imprimir(leido->indice, move(conteos));
+        }
+    };
+
+    vector<thread> lectores, hilos_busqueda;
+    for (int i = 0; i < buscadores; i++) hilos_busqueda.emplace_back(buscador);
+    for (int i = 0; i < LECTORES; i++) lectores.emplace_back(lector);
+    for (auto &h : lectores) h.join();
+    cola.cerrar();
+    for (auto &h : hilos_busqueda) h.join();
+
+    cout << "\nTiempo de ejecución: ";
+    cout << nanosegundos(inicio) << endl;
+    cout << "Lectura: " << ns_lectura << " ns, búsqueda: " << ns_busqueda << " ns (suma de todos los hilos)" << endl;
+    return error ? 1 : 0;
+}
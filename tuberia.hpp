@@ -0,0 +1,20 @@
+#ifndef TUBERIA_HPP
+#define TUBERIA_HPP
+
+#include <string>
+#include <vector>
+using namespace std;
+
+// Búsqueda recursiva en una carpeta y sus subcarpetas (-r) organizada como tubería:
+// hilos lectores cargan cada archivo en un buffer libre y lo dejan en una cola acotada, y hilos buscadores
+// sacan los buffers de la cola, buscan todos los patrones apenas llega cada archivo y devuelven el buffer
+// para reutilizarlo. La lectura del disco y la búsqueda se solapan, así que el tiempo total tiende a
+// max(lectura, búsqueda) en vez de su suma. Cada archivo se busca por separado (sin el texto
+// "$archivo1$archivo2...") y sus ocurrencias se imprimen apenas termina, en el orden de la lista de archivos
+// y con su ruta relativa a la carpeta. Con ignorarMayusculas (-i) no se distinguen mayúsculas
+// y con comodines (-w) los patrones se leen con la sintaxis de PatronComodin.
+int busqueda_recursiva(const string &carpeta, int cantidadArchivos, const string &algoritmo,
+                       const vector<string> &patrones, bool varios_patrones, int buscadores,
+                       bool ignorarMayusculas = false, bool comodines = false);
+
+#endif
@@ -3,108 +3,220 @@
 #include <sstream>
 #include <vector>
 #include <chrono>
+#include <algorithm>
 #include "utils.hpp"
 #include <filesystem>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
 namespace fs = std::filesystem;
 // #include "animation.hpp"
 
-#define BUFFER_SIZE 1024 // Tamaño del buffer para lectura de archivos
-
 using namespace std;
 
 // Variable estática para almacenar el tiempo de inicio del temporizador
 static chrono::high_resolution_clock::time_point startTime;
 
 
-// Función para leer archivos de una carpeta y devolver su contenido como una cadena separada por "$"
+Corpus::~Corpus() {
+    liberar();
+}
+
+void Corpus::liberar() {
+    if (mapa != nullptr) munmap(mapa, largo_mapa);
+    mapa = nullptr;
+    largo_mapa = 0;
+    nombres_archivos.clear(); // La arena no se libera: la próxima carga la reutiliza si cabe en ella
+    datos = nullptr;
+    largo = 0;
+}
+
+// Lista los archivos regulares de una carpeta en el orden del directorio (y de sus subcarpetas si 'recursivo').
+// Si cantidadArchivos es -1, se listan todos los archivos de la carpeta
+vector<string> listar_archivos(const string &carpeta, int cantidadArchivos, bool recursivo) {
+
+    vector<string> archivos;
+    auto agregar = [&](const fs::directory_entry &entry) {
+
+        if (cantidadArchivos == 0) return false; // Si se ha alcanzado la cantidad de archivos, terminar
+
+        if (!fs::is_regular_file(entry.path())) return true; // Solo archivos
+
+        archivos.push_back(entry.path().string());
+        cantidadArchivos--; // Decrementar la cantidad de archivos restantes
+        return true;
+    };
+
+    if (recursivo) {
+        for (const auto & entry : fs::recursive_directory_iterator(carpeta)) if (!agregar(entry)) break;
+    } else {
+        for (const auto & entry : fs::directory_iterator(carpeta)) if (!agregar(entry)) break;
+    }
+    return archivos;
+}
+
+// Ruta de una carpeta sin la barra final, para nombrar los archivos que se guardan junto a ella
+string ruta_base(string carpeta) {
+    while (carpeta.size() > 1 && carpeta.back() == '/') carpeta.pop_back();
+    return carpeta;
+}
+
+// Función para leer archivos de una carpeta en una arena con el formato "$archivo1$archivo2..."
 // Si cantidadArchivos es -1, se leen todos los archivos de la carpeta
-string readFolder(const string &carpeta, vector<int> *posiciones, int cantidadArchivos) {
-    
-    string txt = ""; // Variable para almacenar el contenido del archivo
+bool Corpus::cargarCarpeta(const string &carpeta, vector<uint64_t> *posiciones, int cantidadArchivos) {
+    return cargarArchivos(listar_archivos(carpeta, cantidadArchivos), posiciones);
+}
 
-    for (const auto & entry : fs::directory_iterator(carpeta)){
+// Lee una lista de archivos en la arena con el formato "$archivo1$archivo2..."
+// Primero se suman los tamaños de los archivos para reservar la arena una sola vez,
+// luego cada archivo se lee directamente en su posición (tiempo lineal en el tamaño del corpus).
+bool Corpus::cargarArchivos(const vector<string> &rutas, vector<uint64_t> *posiciones) {
 
-        if (cantidadArchivos == 0) break; // Si se ha alcanzado la cantidad de archivos, salir del bucle
-        
-        if (!fs::is_regular_file(entry.path())) continue; // Solo archivos
-        
-        cout << "Leyendo archivo: " << entry.path().filename() << endl; // Mostrar el nombre del archivo que se está leyendo
+    liberar();
 
-        if (!fs::exists(entry.path())) {
-            cerr << "El archivo no existe: " << entry.path() << endl;
-            return "";
+    // Primera pasada: calcular el tamaño total
+    vector<pair<fs::path, size_t>> archivos;
+    size_t total = 0;
+    for (const string &ruta : rutas) {
+        error_code error;
+        size_t tam = fs::file_size(ruta, error); // Sin excepción: el archivo pudo borrarse después de listarlo
+        if (error) {
+            cerr << "Error al abrir el archivo: " << ruta << endl;
+            return false;
         }
-        
-        ifstream file(entry.path());
-        
+        archivos.push_back({ruta, tam});
+        total += tam + 1; // +1 por el separador "$"
+    }
+
+    char *destino = arena.reservar(total);
+    if (destino == nullptr) return false;
+
+    // Segunda pasada: leer cada archivo directamente en la arena
+    size_t offset = 0;
+    for (const auto &[ruta, tam] : archivos) {
+
+        cout << "Leyendo archivo: " << ruta.filename() << endl; // Mostrar el nombre del archivo que se está leyendo
+
+        ifstream file(ruta, ios::binary);
+
         if (!file.is_open()) {
-            cerr << "Error al abrir el archivo: " << entry.path() << endl;
-            return "";
+            cerr << "Error al abrir el archivo: " << ruta << endl;
+            liberar();
+            return false;
         }
 
-        txt = txt + "$" + string((istreambuf_iterator<char>(file)), istreambuf_iterator<char>());
+        destino[offset++] = '$';
+        file.read(destino + offset, tam);
+        offset += file.gcount(); // Si el archivo cambió de tamaño, se usa lo que realmente se leyó
         file.close();
 
-        
-        // Si se pasan posiciones, agregar la posición del archivo al vector
-        posiciones->push_back(txt.size() - 1); // Agregar la posición del final del archivo
-        
-
-        cantidadArchivos--; // Decrementar la cantidad de archivos restantes   
+        // Agregar la posición del final del archivo
+        posiciones->push_back(offset - 1);
+        nombres_archivos.push_back(ruta.filename().string());
     }
-    return txt; // Devolver el contenido del archivo como una cadena
+    arena.anotarHugePages(); // Ya escrita: se anota ahora por si el programa termina sin liberar la arena
+    datos = destino;
+    largo = offset;
+    return true;
 }
 
-string readFile(const string &archivo) {
-    
-    if (!fs::is_regular_file(archivo)) return ""; // Solo archivos
-    
+// Función para mapear un archivo en memoria sin copiar su contenido
+bool Corpus::cargarArchivo(const string &archivo) {
+
+    liberar();
+
+    if (!fs::is_regular_file(archivo)) return false; // Solo archivos
+
     cout << "Leyendo archivo: " << archivo << endl; // Mostrar el nombre del archivo que se está leyendo
-    
-    if (!fs::exists(archivo)) {
-        cerr << "El archivo no existe: " << archivo << endl;
-        return "";
+
+    int fd = open(archivo.c_str(), O_RDONLY);
+    if (fd < 0) {
+        cerr << "Error al abrir el archivo: " << archivo << endl;
+        return false;
     }
-    
-    // Abrir el archivo y leer su contenido
-    ifstream file(archivo);
 
-    if (!file.is_open()) {
+    struct stat info;
+    if (fstat(fd, &info) < 0) {
         cerr << "Error al abrir el archivo: " << archivo << endl;
-        return "";
+        close(fd);
+        return false;
     }
 
-    string txt = string(istreambuf_iterator<char>(file), istreambuf_iterator<char>());
+    // mmap no acepta regiones de largo 0, un archivo vacío queda como texto vacío
+    if (info.st_size > 0) {
+        mapa = mmap(nullptr, info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (mapa == MAP_FAILED) {
+            mapa = nullptr;
+            cerr << "Error al mapear el archivo: " << archivo << endl;
+            close(fd);
+            return false;
+        }
+        largo_mapa = info.st_size;
+        madvise(mapa, largo_mapa, MADV_SEQUENTIAL); // Los algoritmos recorren el texto de forma secuencial
+        datos = static_cast<const char *>(mapa);
+        largo = largo_mapa;
+    }
+    close(fd); // El mapa sigue siendo válido después de cerrar el descriptor
+
+    return true;
+}
+
+// Función para leer un archivo de patrones generado por utils/generar_patrones.
+// Cada patrón va seguido de "\n", el separador de registro 0x1C y otro "\n".
+bool leerPatrones(const string &archivo, vector<string> *patrones) {
+
+    ifstream file(archivo, ios::binary);
+    if (!file.is_open()) {
+        cerr << "Error al abrir el archivo de patrones: " << archivo << endl;
+        return false;
+    }
+
+    string contenido((istreambuf_iterator<char>(file)), istreambuf_iterator<char>());
     file.close();
-    
-    return txt; // Devolver el contenido del archivo como una cadena
+
+    const string separador = string("\n") + static_cast<char>(28) + "\n";
+    size_t inicio = 0;
+    while (inicio < contenido.size()) {
+        size_t fin = contenido.find(separador, inicio);
+        if (fin == string::npos) fin = contenido.size();
+
+        // Los patrones vacíos se conservan (con 0 coincidencias) para no correr la numeración de los siguientes
+        patrones->push_back(contenido.substr(inicio, fin - inicio));
+        inicio = fin + separador.size();
+    }
+    return true;
 }
 
-void encuentros_por_archivo(const string &carpeta, const vector<int> &posiciones_patrones, const vector<int> &pos_final_archivos) {
+// Función para obtener los nombres de los archivos de la carpeta, en el mismo orden en que los lee Corpus
+static bool nombres_archivos(const string &carpeta, vector<string> *nombres) {
 
     // Verificar si la carpeta existe
     if (!fs::exists(carpeta)) {
         cerr << "La carpeta no existe: " << carpeta << endl;
-        return;
+        return false;
     }
 
     if (!fs::is_directory(carpeta)) {
         cerr << "La ruta especificada no es una carpeta: " << carpeta << endl;
-        return;
+        return false;
     }
 
-    // Almacenar los nombres de los archivos 
-    vector<pair<string, int>> nombres_archivos_vec;
- 
     for (const auto &entry : fs::directory_iterator(carpeta)) {
         if (fs::is_regular_file(entry.path())) {
-            nombres_archivos_vec.push_back({entry.path().filename().string(), 0});
+            nombres->push_back(entry.path().filename().string());
         }
     }
+    return true;
+}
+
+// Función para contar cuántas posiciones (ordenadas) caen dentro de cada archivo
+vector<uint64_t> contar_por_archivo(const vector<uint64_t> &posiciones_patrones, const vector<uint64_t> &pos_final_archivos) {
+
+    vector<uint64_t> conteos(pos_final_archivos.size(), 0);
 
-    
     size_t j = 0;
-    for (size_t i = 0; i < nombres_archivos_vec.size(); ++i) {
+    for (size_t i = 0; i < pos_final_archivos.size(); ++i) {
         
         if (j >= posiciones_patrones.size()) break;
 
@@ -115,16 +227,63 @@ void encuentros_por_archivo(const string &carpeta, const vector<int> &posiciones
 
         // Contar las ocurrencias del patrón en el archivo actual
         while (j < posiciones_patrones.size() && posiciones_patrones[j] <= pos_final_archivos[i]) {
-            nombres_archivos_vec[i].second++;
+            conteos[i]++;
             j++;
         }
     }
-    
-    cout << "\nArchivo, Ocurrencias" << endl;
+    return conteos;
+}
+
+void encuentros_por_archivo(const string &carpeta, const vector<uint64_t> &posiciones_patrones, const vector<uint64_t> &pos_final_archivos) {
+
+    // Almacenar los nombres de los archivos 
+    vector<string> nombres;
+    if (!nombres_archivos(carpeta, &nombres)) return;
+
+    encuentros_por_archivo(nombres, posiciones_patrones, pos_final_archivos);
+}
+
+// Igual que la anterior, pero con los nombres de los archivos ya conocidos (por ejemplo, desde un manifiesto)
+void encuentros_por_archivo(const vector<string> &nombres, const vector<uint64_t> &posiciones_patrones, const vector<uint64_t> &pos_final_archivos) {
+
+    imprimir_conteos(nombres, contar_por_archivo(posiciones_patrones, pos_final_archivos));
+}
+
+// Función para imprimir las ocurrencias de cada archivo (se omiten los archivos sin ocurrencias) en la salida indicada
+void imprimir_conteos(const vector<string> &nombres, const vector<uint64_t> &conteos, ostream &salida) {
+
+    salida << "\nArchivo, Ocurrencias" << endl;
     // Imprimir los resultados
-    for (auto n : nombres_archivos_vec){
-        if (n.second == 0) continue;
-        cout << n.first << ",  " << n.second << endl;
+    for (size_t i = 0; i < conteos.size() && i < nombres.size(); i++){
+        if (conteos[i] == 0) continue;
+        salida << nombres[i] << ",  " << conteos[i] << endl;
+    }
+}
+
+// Función para obtener el índice del archivo al que pertenece una posición del corpus
+size_t archivo_de_posicion(uint64_t posicion, const vector<uint64_t> &pos_final_archivos) {
+    return lower_bound(pos_final_archivos.begin(), pos_final_archivos.end(), posicion) - pos_final_archivos.begin();
+}
+
+// Igual que encuentros_por_archivo, pero para varios patrones a la vez.
+// Los patrones se identifican por su número (desde 1) en el archivo de patrones.
+void encuentros_por_patron(const string &carpeta, const vector<vector<uint64_t>> &posiciones_por_patron, const vector<uint64_t> &pos_final_archivos) {
+
+    vector<string> nombres;
+    if (!nombres_archivos(carpeta, &nombres)) return;
+
+    encuentros_por_patron(nombres, posiciones_por_patron, pos_final_archivos);
+}
+
+void encuentros_por_patron(const vector<string> &nombres, const vector<vector<uint64_t>> &posiciones_por_patron, const vector<uint64_t> &pos_final_archivos) {
+
+    cout << "\nPatron, Archivo, Ocurrencias" << endl;
+    for (size_t p = 0; p < posiciones_por_patron.size(); p++) {
+        vector<uint64_t> conteos = contar_por_archivo(posiciones_por_patron[p], pos_final_archivos);
+        for (size_t i = 0; i < conteos.size() && i < nombres.size(); i++){
+            if (conteos[i] == 0) continue;
+            cout << p + 1 << ",  " << nombres[i] << ",  " << conteos[i] << endl;
+        }
     }
 }
 
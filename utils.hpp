@@ -1,16 +1,59 @@
 #ifndef UTILS_HPP
 #define UTILS_HPP
 
+#include <cstdint>
 #include <vector>
 #include <string>
+#include <string_view>
 #include <iostream>
 #include <fstream>
 #include <chrono>
+#include "memoria.hpp"
 using namespace std;
-string readFolder(const string &carpeta, vector<int> *posiciones, int cantidadArchivos = -1);
-string readFile(const string &archivo);
-void encuentros_por_archivo(const string &carpeta, const vector<int> &posiciones, const vector<int> &pos_final_archivos);
+
+// Corpus de solo lectura sobre el que buscan los algoritmos.
+// Un archivo individual (-a) se mapea en memoria con mmap, sin copiarlo.
+// Una carpeta (-f) se lee en una sola arena reservada de antemano con el tamaño total
+// de los archivos (fs::file_size), con el mismo formato "$archivo1$archivo2..." de siempre.
+// La arena usa huge pages y se conserva entre cargas del mismo Corpus (ver memoria.hpp).
+class Corpus {
+public:
+    Corpus() = default;
+    ~Corpus();
+    Corpus(const Corpus &) = delete;
+    Corpus &operator=(const Corpus &) = delete;
+
+    bool cargarArchivo(const string &archivo);
+    bool cargarCarpeta(const string &carpeta, vector<uint64_t> *posiciones, int cantidadArchivos = -1);
+    bool cargarArchivos(const vector<string> &rutas, vector<uint64_t> *posiciones);
+
+    // Vista del texto completo, valida mientras viva el corpus
+    string_view texto() const { return string_view(datos, largo); }
+    // Nombres de los archivos leídos con cargarCarpeta, en el mismo orden que sus posiciones finales
+    const vector<string> &nombres() const { return nombres_archivos; }
+
+private:
+    void liberar();
+
+    const char *datos = nullptr;  // Inicio del texto (mapa o arena)
+    size_t largo = 0;             // Largo del texto
+    void *mapa = nullptr;         // Region mapeada con mmap (solo para -a)
+    size_t largo_mapa = 0;
+    Arena arena;                  // Memoria de la carpeta concatenada (solo para -f)
+    vector<string> nombres_archivos;
+};
+
+vector<string> listar_archivos(const string &carpeta, int cantidadArchivos = -1, bool recursivo = false);
+string ruta_base(string carpeta);
+bool leerPatrones(const string &archivo, vector<string> *patrones);
+vector<uint64_t> contar_por_archivo(const vector<uint64_t> &posiciones, const vector<uint64_t> &pos_final_archivos);
+size_t archivo_de_posicion(uint64_t posicion, const vector<uint64_t> &pos_final_archivos);
+void imprimir_conteos(const vector<string> &nombres, const vector<uint64_t> &conteos, ostream &salida = cout);
+void encuentros_por_archivo(const string &carpeta, const vector<uint64_t> &posiciones, const vector<uint64_t> &pos_final_archivos);
+void encuentros_por_archivo(const vector<string> &nombres, const vector<uint64_t> &posiciones, const vector<uint64_t> &pos_final_archivos);
+void encuentros_por_patron(const string &carpeta, const vector<vector<uint64_t>> &posiciones_por_patron, const vector<uint64_t> &pos_final_archivos);
+void encuentros_por_patron(const vector<string> &nombres, const vector<vector<uint64_t>> &posiciones_por_patron, const vector<uint64_t> &pos_final_archivos);
 void startTimer();
 void stopTimer();
 
-#endif
\ No newline at end of file
+#endif
@@ -1,21 +1,26 @@
 #include <bits/stdc++.h>
 #include <filesystem>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "../algoritmos/robin_karp.hpp"
 using namespace std;
 namespace fs = std::filesystem;
 
 #define NOMBRE_ARCHIVO  "patrones"
 #define CARPETA_BASE "../archivos_de_prueba/"  // carpeta para generar los patrones
+#define SEPARADOR_PATRONES static_cast<char>(28) // Separador de registro entre patrones
 
 
 
-int generar_numero_random(long long minValue, long long maxValue){
+// Un solo generador para todo el programa, sembrado una vez en main (con --semilla la salida es reproducible)
+mt19937_64 generador;
 
-    random_device rd;                                   // Obtiene un numero aleatorio del sistema
-    mt19937 gen(rd());                                  // Inicializa el generador de numeros aleatorios
-    uniform_int_distribution<> dis(minValue, maxValue); // Distribucion uniforme
-    
-    int numero = dis(gen); // Genera un n├║mero aleatorio en el rango especificado
-    return numero;
+long long generar_numero_random(long long minValue, long long maxValue){
+
+    uniform_int_distribution<long long> dis(minValue, maxValue); // Distribucion uniforme
+    return dis(generador); // Genera un número aleatorio en el rango especificado
 }
 
 void enlistar_archivos(string dir_base, vector<string> *lista_archivos){
@@ -127,25 +132,258 @@ void patron_random(string nombre_archivo, int cant_patrones){
     file_resultados.close();
 }
 
+/* Modo "Carga": genera cargas de trabajo grandes y reproducibles para el benchmark.
+   Los archivos se mapean en memoria una sola vez y cada patrón es una vista de largo fijo sobre el mapa,
+   así que extraer un patrón no abre archivos ni hace lecturas. Los largos se eligen por grupos
+   (primero un grupo al azar y luego un largo dentro de él) para que todos los largos queden representados.
+   Con --zipf se extrae un conjunto de patrones distintos y las consultas se reparten entre ellos con una
+   distribución de Zipf (pocos patrones muy repetidos y muchos poco frecuentes, como en un registro real). */
+struct OpcionesCarga {
+    string carpeta = CARPETA_BASE;
+    vector<pair<size_t, size_t>> largos = {{1, 4}, {5, 8}, {9, 16}, {17, 32}, {33, 64}}; // Grupos de largo
+    double zipf = 0;         // Exponente de Zipf (0: cada patrón se extrae por separado)
+    size_t distintos = 0;    // Patrones distintos con Zipf (0: la décima parte de la cantidad)
+    bool conteos = false;    // Escribir también la cantidad esperada de coincidencias de cada patrón
+};
+
+struct ArchivoMapeado {
+    const char *datos = nullptr;
+    size_t largo = 0;
+};
+
+// Mapea en memoria los archivos (solo lectura). Los archivos vacíos o ilegibles se omiten.
+vector<ArchivoMapeado> mapear_archivos(const vector<string> &rutas){
+    vector<ArchivoMapeado> mapeados;
+    for (const string &ruta : rutas) {
+        int fd = open(ruta.c_str(), O_RDONLY);
+        if (fd < 0) {
+            cerr << "Error al abrir el archivo: " << ruta << endl;
+            continue;
+        }
+        struct stat info;
+        if (fstat(fd, &info) == 0 && info.st_size > 0) {
+            void *mapa = mmap(nullptr, info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (mapa != MAP_FAILED) mapeados.push_back({static_cast<const char *>(mapa), static_cast<size_t>(info.st_size)});
+            else cerr << "Error al mapear el archivo: " << ruta << endl;
+        }
+        close(fd);
+    }
+    return mapeados;
+}
+
+// Grupos de largo con el formato "1-4,5-8,9-16" (un largo suelto "8" es el grupo 8-8)
+bool leer_largos(const string &texto, vector<pair<size_t, size_t>> *largos){
+    largos->clear();
+    stringstream grupos(texto);
+    string grupo;
+    while (getline(grupos, grupo, ',')) {
+        size_t guion = grupo.find('-');
+        size_t minimo = stoul(grupo.substr(0, guion));
+        size_t maximo = guion == string::npos ? minimo : stoul(grupo.substr(guion + 1));
+        if (minimo < 1 || maximo < minimo) return false;
+        largos->push_back({minimo, maximo});
+    }
+    return !largos->empty();
+}
+
+// Extrae un patrón del largo pedido desde una posición uniforme del corpus (todos los bytes con la misma
+// probabilidad). 'acumulado[a]' es el total de bytes hasta el archivo a inclusive.
+// Devuelve una vista vacía si no encuentra un archivo suficientemente largo.
+string_view extraer_patron(const vector<ArchivoMapeado> &archivos, const vector<uint64_t> &acumulado, size_t largo){
+    for (int intento = 0; intento < 100; intento++) {
+        uint64_t offset = generar_numero_random(0, acumulado.back() - 1);
+        size_t a = upper_bound(acumulado.begin(), acumulado.end(), offset) - acumulado.begin();
+        const ArchivoMapeado &archivo = archivos[a];
+        if (archivo.largo < largo) continue;
+        size_t posicion = min<uint64_t>(offset - (acumulado[a] - archivo.largo), archivo.largo - largo);
+        string_view patron(archivo.datos + posicion, largo);
+        // El separador del archivo de patrones no puede aparecer dentro de un patrón
+        if (patron.find(SEPARADOR_PATRONES) == string_view::npos) return patron;
+    }
+    return string_view();
+}
+
+/* Cuenta las ocurrencias (con traslape, dentro de cada archivo) de cada patrón, que es lo que informa
+   detectar_patrones por archivo. Se hace una pasada con hash rodante por cada largo distinto: cada ventana
+   se descarta con un filtro de bits indexado por su hash y solo las que pasan se buscan en la tabla. */
+vector<uint64_t> contar_ocurrencias(const vector<ArchivoMapeado> &archivos, const vector<string_view> &patrones){
+
+    vector<uint64_t> conteos(patrones.size(), 0);
+    map<size_t, vector<size_t>> por_largo;
+    for (size_t p = 0; p < patrones.size(); p++) por_largo[patrones[p].size()].push_back(p);
+
+    const uint64_t BITS_FILTRO = 1 << 22;
+    for (const auto &[m, grupo] : por_largo) {
+        unordered_map<uint64_t, vector<size_t>> tabla;
+        vector<bool> filtro(BITS_FILTRO, false);
+        for (size_t p : grupo) {
+            uint64_t h = robin_karp::hash(patrones[p], m);
+            tabla[h].push_back(p);
+            filtro[h % BITS_FILTRO] = true;
+        }
+        uint64_t peso = robin_karp::peso(m);
+
+        for (const ArchivoMapeado &archivo : archivos) {
+            if (archivo.largo < m) continue;
+            string_view texto(archivo.datos, archivo.largo);
+            uint64_t h = robin_karp::hash(texto, m);
+            for (size_t i = 0; ; i++) {
+                if (filtro[h % BITS_FILTRO]) {
+                    auto it = tabla.find(h);
+                    if (it != tabla.end()) {
+                        for (size_t p : it->second) {
+                            if (memcmp(texto.data() + i, patrones[p].data(), m) == 0) conteos[p]++;
+                        }
+                    }
+                }
+                if (i + m >= texto.size()) break;
+                h = robin_karp::rodar(h, texto[i], texto[i + m], peso);
+            }
+        }
+    }
+    return conteos;
+}
+
+void patron_carga(string nombre_archivo, int cant_patrones, const OpcionesCarga &opciones){
+
+    vector<string> lista_archivos;
+    enlistar_archivos(opciones.carpeta, &lista_archivos);
+    sort(lista_archivos.begin(), lista_archivos.end()); // Mismo orden en cada ejecución, para que la semilla baste
+    vector<ArchivoMapeado> archivos = mapear_archivos(lista_archivos);
+    if (archivos.empty()) {
+        cerr << "No hay archivos con contenido en: " << opciones.carpeta << endl;
+        exit(1);
+    }
+    vector<uint64_t> acumulado;
+    uint64_t total = 0;
+    for (const ArchivoMapeado &archivo : archivos) acumulado.push_back(total += archivo.largo);
+
+    // Con Zipf primero se extraen los patrones distintos y luego se sortean las consultas entre ellos
+    size_t cant_extraer = cant_patrones;
+    if (opciones.zipf > 0) {
+        cant_extraer = opciones.distintos > 0 ? opciones.distintos : max(1, cant_patrones / 10);
+    }
+    vector<string_view> extraidos;
+    extraidos.reserve(cant_extraer);
+    for (size_t i = 0; i < cant_extraer; i++) {
+        const auto &[minimo, maximo] = opciones.largos[generar_numero_random(0, opciones.largos.size() - 1)];
+        string_view patron = extraer_patron(archivos, acumulado, generar_numero_random(minimo, maximo));
+        if (patron.empty()) {
+            cerr << "No hay archivos de al menos " << minimo << " bytes sin el separador de patrones." << endl;
+            exit(1);
+        }
+        extraidos.push_back(patron);
+    }
+
+    vector<string_view> patrones;
+    if (opciones.zipf > 0) {
+        // Distribución acumulada de Zipf: el patrón de rango r tiene peso 1 / r^s
+        vector<double> acumulada(extraidos.size());
+        double suma = 0;
+        for (size_t r = 0; r < extraidos.size(); r++) acumulada[r] = suma += 1.0 / pow(r + 1, opciones.zipf);
+        uniform_real_distribution<double> uniforme(0, suma);
+        patrones.reserve(cant_patrones);
+        for (int i = 0; i < cant_patrones; i++) {
+            size_t r = lower_bound(acumulada.begin(), acumulada.end(), uniforme(generador)) - acumulada.begin();
+            patrones.push_back(extraidos[min(r, extraidos.size() - 1)]);
+        }
+    } else {
+        patrones = move(extraidos);
+    }
+
+    // Escribir todo con un solo buffer
+    string salida;
+    for (string_view patron : patrones) {
+        salida.append(patron);
+        salida += '\n';
+        salida += SEPARADOR_PATRONES;
+        salida += '\n';
+    }
+    ofstream file_resultados(nombre_archivo, ios::binary);
+    if (!file_resultados.is_open()) {
+        exit(1);
+    }
+    file_resultados.write(salida.data(), salida.size());
+    file_resultados.close();
+
+    if (opciones.conteos) {
+        // Se cuenta cada patrón distinto una sola vez
+        unordered_map<string_view, size_t> indice;
+        vector<string_view> distintos;
+        for (string_view patron : patrones) {
+            if (indice.emplace(patron, distintos.size()).second) distintos.push_back(patron);
+        }
+        vector<uint64_t> conteos = contar_ocurrencias(archivos, distintos);
+
+        // Mismo formato que detectar_patrones con -p: número de patrón (desde 1) y coincidencias
+        ofstream file_conteos(nombre_archivo + ".conteos");
+        if (!file_conteos.is_open()) {
+            exit(1);
+        }
+        string lineas;
+        for (size_t i = 0; i < patrones.size(); i++) {
+            lineas += to_string(i + 1) + ",  " + to_string(conteos[indice[patrones[i]]]) + "\n";
+        }
+        file_conteos << lineas;
+    }
+
+    for (const ArchivoMapeado &archivo : archivos) munmap(const_cast<char *>(archivo.datos), archivo.largo);
+}
+
 int main(int argc, char* argv[]){
 
-    if(argc < 3){
+    // Separar las opciones (solo para el modo Carga) de los argumentos posicionales
+    // --semilla <N>: semilla del generador (por defecto una al azar; la misma semilla da la misma salida)
+    // --carpeta <Carpeta>: carpeta de donde se extraen los patrones
+    // --largos <Grupos>: grupos de largo, por ejemplo 1-4,5-8,9-16
+    // --zipf <s> y --distintos <K>: repartir los patrones entre K distintos con una distribución de Zipf
+    // --conteos: escribir también <NombreArchivo>.conteos con las coincidencias esperadas de cada patrón
+    OpcionesCarga opciones;
+    uint64_t semilla = random_device()();
+    vector<string> args;
+    for (int i = 1; i < argc; i++) {
+        string arg = argv[i];
+        if (arg == "--semilla" && i + 1 < argc) {
+            semilla = stoull(argv[++i]);
+        } else if (arg == "--carpeta" && i + 1 < argc) {
+            opciones.carpeta = argv[++i];
+        } else if (arg == "--largos" && i + 1 < argc) {
+            if (!leer_largos(argv[++i], &opciones.largos)) {
+                cerr << "Grupos de largo no válidos. Ejemplo: --largos 1-4,5-8,9-16" << endl;
+                return 1;
+            }
+        } else if (arg == "--zipf" && i + 1 < argc) {
+            opciones.zipf = stod(argv[++i]);
+        } else if (arg == "--distintos" && i + 1 < argc) {
+            opciones.distintos = stoul(argv[++i]);
+        } else if (arg == "--conteos") {
+            opciones.conteos = true;
+        } else {
+            args.push_back(arg);
+        }
+    }
+    generador.seed(semilla);
+
+    if(args.size() < 2){
         // NombreArchivo es opcional
-        printf("Uso: %s <CantidadPatrones> <TipoPatrones> <NombreArchivo>", argv[0]);
+        printf("Uso: %s <CantidadPatrones> <TipoPatrones> <NombreArchivo>\n", argv[0]);
+        printf("     %s <CantidadPatrones> Carga <NombreArchivo> [--semilla N] [--carpeta C] [--largos 1-4,5-8] [--zipf s] [--distintos K] [--conteos]\n", argv[0]);
         return 1;
     }
 
-    int cantidad_patrones = stoi(argv[1]);
-    string tipo_patron = argv[2];
+    int cantidad_patrones = stoi(args[0]);
+    string tipo_patron = args[1];
 
     string nombre = NOMBRE_ARCHIVO;
-    if(argc == 4){
-        nombre = argv[3];
+    if(args.size() >= 3){
+        nombre = args[2];
     }
 
     if(tipo_patron == "Random"){
         patron_random(nombre, cantidad_patrones);
     } else if (tipo_patron == "Existente"){
         patron_existente(nombre, cantidad_patrones);
+    } else if (tipo_patron == "Carga"){
+        patron_carga(nombre, cantidad_patrones, opciones);
     }
-}
\ No newline at end of file
+}